@@ -13,6 +13,8 @@ Define before inclusion (only those needed):
     PDC_RGB         if you want to use RGB color definitions
                     (Red = 1, Green = 2, Blue = 4) instead of BGR
     PDC_WIDE        if building / built with wide-character support
+    CHTYPE_64       if building / built with a 64-bit chtype, for
+                    65536 color pairs
     PDC_DLL_BUILD   if building / built as a Windows DLL
     PDC_NCMOUSE     to use the ncurses mouse API instead
                     of PDCurses' traditional mouse API
@@ -87,10 +89,18 @@ extern "C"
 typedef unsigned char bool;
 #endif
 
-#if _LP64
-typedef unsigned int chtype;
+#ifdef CHTYPE_64
+# if _LP64
+typedef unsigned long chtype;       /* 48-bit attr + 16-bit char */
+# else
+typedef unsigned long long chtype;
+# endif
 #else
+# if _LP64
+typedef unsigned int chtype;
+# else
 typedef unsigned long chtype;  /* 16-bit attr + 16-bit char */
+# endif
 #endif
 
 #ifdef PDC_WIDE
@@ -118,6 +128,16 @@ typedef struct
     unsigned char bsize;  /* sizeof bool */
 } PDC_VERSION;
 
+/* A view of another process's screen, from PDC_mirror_begin() */
+
+typedef struct
+{
+    int lines, cols;      /* size of the screen */
+    int cury, curx;       /* cursor position */
+    unsigned long frame;  /* updates published so far */
+    const chtype *cells;  /* lines * cols cells, row by row */
+} PDC_MIRROR;
+
 enum
 {
     PDC_VFLAG_DEBUG = 1,  /* set if built with -DPDCDEBUG */
@@ -300,6 +320,16 @@ typedef struct _win       /* definition of a window */
     int   _delayms;       /* milliseconds of delay for getch() */
     int   _parx, _pary;   /* coords relative to parent (0,0) */
     struct _win *_parent; /* subwin's pointer to parent win */
+    int   _ycap;          /* lines allocated in _y, _firstch, _lastch */
+    int   _xcap;          /* cells allocated in each line */
+    int   _pady, _padx;   /* pad corner shown by the last pnoutrefresh() */
+    int   _padtop, _padleft,
+          _padbottom, _padright; /* ...and where it went on the screen */
+    unsigned long *_dirty; /* changed chunks of each line, as bits */
+    int   _dwords;        /* words of _dirty per line */
+    int   _touched;       /* lines with changes, i.e. with _firstch set */
+    unsigned long _gen;   /* counts changes, to tell if any happened */
+    struct _vpad_t *_vpad; /* row cache of a virtual pad, else NULL */
 } WINDOW;
 
 /* Color pair structure */
@@ -308,7 +338,6 @@ typedef struct
 {
     short f;              /* foreground color */
     short b;              /* background color */
-    bool  set;            /* pair has been set */
 } PDC_PAIR;
 
 /* Avoid using the SCREEN struct directly -- use the corresponding
@@ -335,9 +364,13 @@ typedef struct
     int   lines;          /* new value for LINES */
     int   cols;           /* new value for COLS */
     mmask_t _trap_mbe;             /* trap these mouse button events */
-    int   mouse_wait;              /* time to wait (in ms) for a
-                                      button release after a press, in
-                                      order to count it as a click */
+    int   mouse_wait;              /* longest time (in ms) between a
+                                      button press and its release, for
+                                      it to count as a click */
+    unsigned long mouse_time[3];   /* timestamp (ms) of the last press,
+                                      or of the release ending a click */
+    short mouse_clicks[3];         /* clicks counted so far in the
+                                      current click series */
     int   slklines;                /* lines in use by slk_init() */
     WINDOW *slk_winptr;            /* window for slk */
     int   linesrippedoff;          /* lines ripped off via ripoffline() */
@@ -364,6 +397,7 @@ typedef struct
     bool  dirty;          /* redraw on napms() after init_color() */
     int   sel_start;      /* start of selection (y * COLS + x) */
     int   sel_end;        /* end of selection */
+    bool  paste_pending;  /* a paste is still arriving */
     int  *c_buffer;       /* character buffer */
     int   c_pindex;       /* putter index */
     int   c_gindex;       /* getter index */
@@ -371,6 +405,8 @@ typedef struct
     int   c_ungind;       /* ungetch() push index */
     int   c_ungmax;       /* allocated size of ungetch() buffer */
     PDC_PAIR *atrtab;     /* table of color pairs */
+    struct _opaque_screen_t *opaque; /* library-internal per-screen
+                                        state */
 } SCREEN;
 
 /*----------------------------------------------------------------------
@@ -418,6 +454,24 @@ for character data. The modifiers are bold, underline, right-line,
 left-line, italic, reverse and blink, plus the alternate character set
 indicator.
 
+When built with CHTYPE_64, the chtype is a 64-bit integer instead, and
+the color pair takes bits 24 through 39, for 65536 pairs. The other
+fields are unchanged. Pairs above 32767 can't be passed as a short; use
+init_extended_pair(), alloc_pair() and the opts argument of functions
+like wattr_set() to reach them.
+
+The top bit, A_RGB_COLOR, marks a direct-color cell, which bypasses the
+color pairs: bits 24 through 59 then hold its foreground and background
+as RGB values, with 6 bits per channel. A_RGB(fg, bg) makes such a
+color from two 0xRRGGBB values (of which it keeps the high 6 bits of
+each channel), for use with attrset(), attron(), or in a chtype:
+
+    attrset(A_RGB(0xff8000, 0x000040));
+    addch('x' | A_RGB(0x00c0ff, 0x202020) | A_BOLD);
+
+Ports that can't show such colors directly use the nearest of the 16
+basic colors. PAIR_NUMBER() is meaningless for a direct-color cell.
+
 **man-end****************************************************************/
 
 /*** Video attribute macros ***/
@@ -433,12 +487,29 @@ indicator.
 #define A_BLINK       (chtype)0x00400000
 #define A_BOLD        (chtype)0x00800000
 
-#define A_ATTRIBUTES  (chtype)0xffff0000
 #define A_CHARTEXT    (chtype)0x0000ffff
-#define A_COLOR       (chtype)0xff000000
 
 #define PDC_COLOR_SHIFT 24
 
+#ifdef CHTYPE_64
+# define A_COLOR      (~(chtype)0 << PDC_COLOR_SHIFT)    /* pair or RGB */
+# define A_ATTRIBUTES (A_COLOR | (chtype)0x00ff0000)
+# define A_RGB_COLOR  ((chtype)1 << 63)
+
+/* 0xRRGGBB to 6 bits per channel */
+
+# define PDC_RGB18(c) ( (((chtype)(c) >> 6) & 0x3f000) | \
+                        (((chtype)(c) >> 4) & 0xfc0) | \
+                        (((chtype)(c) >> 2) & 0x3f) )
+
+# define A_RGB(fg, bg) (A_RGB_COLOR | \
+                        (PDC_RGB18(fg) << PDC_COLOR_SHIFT) | \
+                        (PDC_RGB18(bg) << (PDC_COLOR_SHIFT + 18)))
+#else
+# define A_ATTRIBUTES (chtype)0xffff0000
+# define A_COLOR      (chtype)0xff000000
+#endif
+
 #define A_LEFTLINE    A_LEFT
 #define A_RIGHTLINE   A_RIGHT
 #define A_STANDOUT    (A_REVERSE | A_BOLD) /* X/Open */
@@ -1282,9 +1353,14 @@ PDCEX  mmask_t getmouse(void);
 
 /* ncurses */
 
+PDCEX  int     alloc_pair(int, int);
 PDCEX  int     assume_default_colors(int, int);
 PDCEX  const char *curses_version(void);
+PDCEX  int     extended_pair_content(int, int *, int *);
+PDCEX  int     find_pair(int, int);
+PDCEX  int     free_pair(int);
 PDCEX  bool    has_key(int);
+PDCEX  int     init_extended_pair(int, int, int);
 PDCEX  bool    is_keypad(const WINDOW *);
 PDCEX  bool    is_leaveok(const WINDOW *);
 PDCEX  bool    is_pad(const WINDOW *);
@@ -1314,9 +1390,13 @@ PDCEX  int     mvwaddrawch(WINDOW *, int, int, chtype);
 PDCEX  int     mvwdeleteln(WINDOW *, int, int);
 PDCEX  int     mvwinsertln(WINDOW *, int, int);
 PDCEX  int     mvwinsrawch(WINDOW *, int, int, chtype);
+PDCEX  WINDOW *newvpad(int, int, int,
+                       int (*)(WINDOW *, int, chtype *, void *), void *);
 PDCEX  int     raw_output(bool);
 PDCEX  int     resize_term(int, int);
 PDCEX  WINDOW *resize_window(WINDOW *, int, int);
+PDCEX  int     vpad_invalidate(WINDOW *, int, int);
+PDCEX  int     vpad_resize(WINDOW *, int);
 PDCEX  int     waddrawch(WINDOW *, chtype);
 PDCEX  int     winsrawch(WINDOW *, chtype);
 PDCEX  char    wordchar(void);
@@ -1326,16 +1406,27 @@ PDCEX  wchar_t *slk_wlabel(int);
 #endif
 
 PDCEX  void    PDC_debug(const char *, ...);
+PDCEX  int     PDC_flush_frame(void);
 PDCEX  void    PDC_get_version(PDC_VERSION *);
+PDCEX  PDC_MIRROR *PDC_mirror_attach(const char *);
+PDCEX  unsigned long PDC_mirror_begin(PDC_MIRROR *);
+PDCEX  void    PDC_mirror_detach(PDC_MIRROR *);
+PDCEX  int     PDC_mirror_screen(const char *);
+PDCEX  bool    PDC_mirror_valid(PDC_MIRROR *, unsigned long);
+PDCEX  int     PDC_record(FILE *);
 PDCEX  int     PDC_ungetch(int);
 PDCEX  int     PDC_set_blink(bool);
 PDCEX  int     PDC_set_bold(bool);
+PDCEX  int     PDC_set_frame_rate(int);
 PDCEX  int     PDC_set_line_color(short);
+PDCEX  int     PDC_set_render_thread(bool);
 PDCEX  void    PDC_set_title(const char *);
 
 PDCEX  int     PDC_clearclipboard(void);
 PDCEX  int     PDC_freeclipboard(char *);
 PDCEX  int     PDC_getclipboard(char **, long *);
+PDCEX  int     PDC_pollclipboard(char **, long *);
+PDCEX  int     PDC_requestclipboard(void);
 PDCEX  int     PDC_setclipboard(const char *, long);
 
 PDCEX  unsigned long PDC_get_key_modifiers(void);
@@ -1367,8 +1458,13 @@ PDCEX  int     wunderscore(WINDOW *);
 #define getch()            wgetch(stdscr)
 #define ungetch(ch)        PDC_ungetch(ch)
 
-#define COLOR_PAIR(n)      (((chtype)(n) << PDC_COLOR_SHIFT) & A_COLOR)
-#define PAIR_NUMBER(n)     (((n) & A_COLOR) >> PDC_COLOR_SHIFT)
+#ifdef CHTYPE_64
+# define COLOR_PAIR(n)     (((chtype)(n) & 0xffff) << PDC_COLOR_SHIFT)
+# define PAIR_NUMBER(n)    ((((n) & A_COLOR) >> PDC_COLOR_SHIFT) & 0xffff)
+#else
+# define COLOR_PAIR(n)     (((chtype)(n) << PDC_COLOR_SHIFT) & A_COLOR)
+# define PAIR_NUMBER(n)    (((n) & A_COLOR) >> PDC_COLOR_SHIFT)
+#endif
 
 /* These will _only_ work as macros */
 
@@ -1389,12 +1485,14 @@ PDCEX  int     wunderscore(WINDOW *);
 #define PDC_save_key_modifiers(x)  (OK)
 #define PDC_get_input_fd()         0
 
-/* return codes from PDC_getclipboard() and PDC_setclipboard() calls */
+/* return codes from PDC_getclipboard(), PDC_pollclipboard() and
+   PDC_setclipboard() calls */
 
 #define PDC_CLIP_SUCCESS         0
 #define PDC_CLIP_ACCESS_ERROR    1
 #define PDC_CLIP_EMPTY           2
 #define PDC_CLIP_MEMORY_ERROR    3
+#define PDC_CLIP_PENDING         4
 
 /* PDCurses key modifier masks */
 
@@ -28,6 +28,117 @@ typedef struct           /* structure for ripped off lines */
     int (*init)(WINDOW *, int);
 } RIPPEDOFFLINE;
 
+typedef struct           /* one changed run of cells, for
+                            PDC_transform_frame */
+{
+    int y, x, len;
+    const chtype *srcp;
+} PDC_SPAN;
+
+typedef struct           /* index entry for find_pair()/alloc_pair() */
+{
+    int next;            /* next pair in the same hash chain, or -1 */
+    int older, newer;    /* neighbours on the alloc_pair() list, or -1 */
+    bool listed;         /* on that list, i.e. may be recycled */
+} PDC_PAIRLINK;
+
+/* The tty modes kept by def_prog_mode(), def_shell_mode() and
+   savetty(); only these come back, so the rest of the screen's state
+   stays as it is */
+
+enum { PDC_SH_TTY, PDC_PR_TTY, PDC_SAVE_TTY };
+
+typedef struct
+{
+    bool been_set;
+    bool autocr, cbreak, echo, raw_inp, raw_out, audible;
+    int delaytenths, visibility, lines, cols, cursrow, curscol;
+} PDC_TTY;
+
+/* State that belongs to one SCREEN, beyond what the public struct
+   holds. While a screen isn't current, its curscr, stdscr, TABSIZE and
+   Mouse_status are parked here too. */
+
+struct SLK;
+
+struct _opaque_screen_t
+{
+    WINDOW *curscr;
+    WINDOW *stdscr;
+    int tabsize;
+    MOUSE_STATUS mouse_status;
+
+    bool headless;               /* never drawn; see newterm() */
+    short *palette;              /* a headless screen's colors, as r, g,
+                                    b for each; NULL until needed */
+
+    bool default_colors;         /* use_default_colors() in effect */
+    short first_col;             /* lowest color init_pair() accepts */
+    bool stale_pairs;            /* some pair is marked stale */
+    unsigned long *pair_set;     /* bitmap of pairs that were set */
+    unsigned long *pair_stale;   /* bitmap of pairs needing a redraw */
+
+    int *pair_hash;              /* find_pair() hash chains, or NULL if
+                                    the index isn't built yet */
+    PDC_PAIRLINK *pair_link;     /* one per pair */
+    int pair_oldest;             /* least recently used alloc_pair() */
+    int pair_newest;             /* most recently used */
+    int pair_free;               /* no unset pair below this one */
+
+    bool ungot;                  /* ungetmouse() event pending */
+
+    PDC_TTY ctty[3];             /* saved tty modes, see kernel.c */
+
+    struct SLK *slk;             /* soft label keys */
+    int slk_labels;
+    int slk_length;
+    int slk_fmt;
+    int slk_line;
+    bool slk_hidden;
+
+    PDC_SPAN *spans;             /* changes collected by doupdate() */
+    int span_max;                /* allocated size of spans */
+
+    bool scroll_hint;            /* a region of curscr moved, as below */
+    int scroll_top, scroll_left, scroll_bottom, scroll_right;
+    int scroll_dy, scroll_dx;    /* cell (y, x) now shows (y+dy, x+dx) */
+
+    unsigned long *blinkmap;     /* bits marking the A_BLINK cells of
+                                    lastscr, row by row */
+    long blinkcount;             /* number of bits set in blinkmap */
+
+    int frame_ms;                /* minimum interval between updates,
+                                    set by PDC_set_frame_rate() */
+    unsigned long frame_time;    /* PDC_ms_count() at the last update */
+    bool frame_deferred;         /* an update is waiting for its
+                                    interval */
+
+    struct _pdc_mirror *mirror;  /* shared-memory copy of the screen */
+    struct _pdc_record *record;  /* session being recorded */
+};
+
+/* A frame delta: a copy of the screen, plus the span of each row that
+   changed since it was last drawn. Each cell's pair is looked up as
+   it's stored, and the screen settings that drawing depends on are
+   copied with it, so that a renderer on another thread needn't read
+   SP. */
+
+typedef struct
+{
+    int lines, cols;
+    chtype *cells;        /* lines * cols, row by row */
+    short *fore, *back;   /* each cell's pair colors (-1 for direct
+                             color cells) */
+    int *firstch;         /* first changed column in each row */
+    int *lastch;          /* last changed column in each row */
+    int cursrow, curscol; /* cursor position */
+    int visibility;       /* cursor visibility */
+    attr_t termattrs;     /* SP->termattrs, */
+    short line_color;     /* SP->line_color, */
+    bool mono;            /* and SP->mono, as of the last store */
+    bool ready;           /* a complete update is waiting */
+} PDC_FRAME;
+
 /* Window properties */
 
 #define _SUBWIN    0x01  /* window is a subwindow */
@@ -62,6 +173,7 @@ bool    PDC_has_mouse(void);
 int     PDC_init_color(short, short, short, short);
 int     PDC_modifiers_set(void);
 int     PDC_mouse_set(void);
+unsigned long PDC_ms_count(void);
 void    PDC_napms(int);
 void    PDC_reset_prog_mode(void);
 void    PDC_reset_shell_mode(void);
@@ -78,15 +190,48 @@ void    PDC_set_keyboard_binary(bool);
 void    PDC_transform_line(int, int, int, const chtype *);
 const char *PDC_sysname(void);
 
+/* Optional platform hook; see IMPLEMNT.md */
+
+extern void (*PDC_transform_frame)(const PDC_SPAN *, int);
+extern int (*PDC_move_rect)(int, int, int, int, int, int);
+extern int (*PDC_clip_request)(void);
+extern int (*PDC_clip_poll)(char **, long *);
+
 /* Internal cross-module functions */
 
+void    PDC_blink_alloc(void);
+void    PDC_cell_colors(chtype, int *, int *);
+void    PDC_frame_free(PDC_FRAME *);
+int     PDC_frame_resize(PDC_FRAME *, int, int);
+void    PDC_frame_store(PDC_FRAME *, int, int, int, const chtype *);
+void    PDC_frame_take(PDC_FRAME *, PDC_FRAME *);
+int     PDC_frame_due(void);
 void    PDC_init_atrtab(void);
+int     PDC_makedirty(WINDOW *, int, int);
+void    PDC_mirror_mark(int, int, int);
+void    PDC_mirror_publish(void);
+void    PDC_record_cells(int, int, int, const chtype *);
+void    PDC_record_frame(void);
+void    PDC_record_key(int);
+void    PDC_record_move(int, int, int, int, int, int);
 WINDOW *PDC_makelines(WINDOW *);
 WINDOW *PDC_makenew(int, int, int, int);
+short   PDC_mouse_click(int, bool, unsigned long);
+bool    PDC_next_change(const WINDOW *, int, int *, int *);
 int     PDC_mouse_in_slk(int, int);
+void    PDC_redraw_blink(void);
+void    PDC_scroll_hint(int, int, int, int, int, int);
+void    PDC_scroll_lines(WINDOW *, int, int, int);
 void    PDC_slk_free(void);
 void    PDC_slk_initialize(void);
 void    PDC_sync(WINDOW *);
+void    PDC_touch_span(WINDOW *, int, int, int);
+void    PDC_untouch_line(WINDOW *, int);
+void    PDC_vpad_free(WINDOW *);
+
+#ifdef A_RGB_COLOR
+unsigned long PDC_rgb24(chtype);
+#endif
 
 #ifdef PDC_WIDE
 int     PDC_mbtowc(wchar_t *, const char *, size_t);
@@ -113,8 +258,35 @@ size_t  PDC_wcstombs(char *, const wchar_t *, size_t);
 
 #define PDC_CLICK_PERIOD 150  /* time to wait for a click, if
                                  not set by mouseinterval() */
-#define PDC_COLOR_PAIRS  256
+#ifdef CHTYPE_64
+# define PDC_COLOR_PAIRS 65536
+#else
+# define PDC_COLOR_PAIRS 256
+#endif
 #define PDC_MAXCOL       768  /* maximum possible COLORS; may be less */
+#define PDC_RESIZE_SETTLE 100 /* ms without further resize events
+                                 before KEY_RESIZE is reported */
+
+#define PDC_BLINK_BITS   (sizeof(unsigned long) * 8)
+#define PDC_BLINK_WORDS(cols) (((cols) + PDC_BLINK_BITS - 1) / PDC_BLINK_BITS)
+
+/* Each window records which chunks of PDC_CHUNK cells in each line have
+   changed, as well as the bounds of the changes in _firstch and
+   _lastch; see touch.c */
+
+#define PDC_CHUNK        8
+#define PDC_DIRTY_WORDS(cols) \
+    PDC_BLINK_WORDS(((cols) + PDC_CHUNK - 1) / PDC_CHUNK)
+#define PDC_DIRTY(win, y) ((win)->_dirty + (y) * (win)->_dwords)
+
+#define PDC_PAIR_WORDS   PDC_BLINK_WORDS(PDC_COLOR_PAIRS)
+#define PDC_PAIR_TEST(map, pair) \
+    ((map)[(pair) / PDC_BLINK_BITS] & (1UL << ((pair) % PDC_BLINK_BITS)))
+
+#ifdef A_RGB_COLOR                /* colors of a direct-color cell */
+# define PDC_RGB_FORE(ch) PDC_rgb24((ch) >> PDC_COLOR_SHIFT)
+# define PDC_RGB_BACK(ch) PDC_rgb24((ch) >> (PDC_COLOR_SHIFT + 18))
+#endif
 
 #define _INBUFSIZ        512  /* size of terminal input buffer */
 #define NUNGETCH         256  /* max # chars to ungetch() */
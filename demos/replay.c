@@ -0,0 +1,351 @@
+/* replay -- play back a session recorded with PDC_record()
+
+   usage: replay [-f] [-n] [-k] file
+
+   -f  as fast as possible, then report the frame rate
+   -n  no screen: just apply the recording, then print the final
+       screen as text, with some statistics
+   -k  (with -n) list the keys that were pressed
+
+   While playing on the screen, press 'q' to stop. */
+
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static FILE *rec;
+static WINDOW *input;       /* a pad, so reading keys doesn't refresh */
+static int chsize, lines, cols;
+static chtype *shadow;      /* the recorded screen */
+static bool headless, fast, listkeys;
+
+static long frames, cells, keys;
+static unsigned long clock_ms;  /* time into the recording */
+
+static unsigned long get_num(void)
+{
+    unsigned long n = 0;
+    int c, shift = 0;
+
+    do
+    {
+        c = getc(rec);
+        if (c == EOF)
+            return 0;
+
+        n |= (unsigned long)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    return n;
+}
+
+static long get_signed(void)
+{
+    unsigned long n = get_num();
+
+    return (n & 1) ? -(long)(n >> 1) - 1 : (long)(n >> 1);
+}
+
+static chtype get_cell(void)
+{
+    chtype ch = 0;
+    int i;
+
+    for (i = 0; i < chsize; i++)
+        ch |= (chtype)(getc(rec) & 0xff) << (8 * i);
+
+    return ch;
+}
+
+/* copy row y, columns x to x + n - 1, from the shadow to stdscr */
+
+static void show(int y, int x, int n)
+{
+    if (headless || y >= LINES || x >= COLS)
+        return;
+
+    if (n > COLS - x)
+        n = COLS - x;
+
+    mvwaddchnstr(stdscr, y, x, shadow + y * cols + x, n);
+}
+
+static void new_size(int l, int c)
+{
+    lines = l;
+    cols = c;
+
+    free(shadow);
+    shadow = calloc((size_t)lines * cols + 1, sizeof(chtype));
+    if (!shadow)
+    {
+        if (!headless)
+            endwin();
+
+        fprintf(stderr, "replay: out of memory\n");
+        exit(1);
+    }
+
+    if (!headless)
+    {
+        resize_term(lines, cols);
+        erase();
+    }
+}
+
+static void cells_at(int y, int x, int n, bool repeat)
+{
+    chtype ch = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!i || !repeat)
+            ch = get_cell();
+
+        if (y < lines && x + i < cols)
+            shadow[y * cols + x + i] = ch;
+    }
+
+    cells += n;
+
+    if (y < lines && x < cols)
+        show(y, x, (x + n > cols) ? cols - x : n);
+}
+
+/* the same as doupdate() does with the screen; rows that scroll in
+   keep what was there, as on the real screen */
+
+static void move_rect(int top, int left, int bottom, int right,
+                      int dy, int dx)
+{
+    int to = (dx < 0) ? left - dx : left;
+    int width = right - left + 1 - abs(dx);
+    int y, step = (dy < 0) ? -1 : 1;
+
+    if (bottom >= lines || right >= cols || width <= 0)
+        return;
+
+    for (y = (dy < 0) ? bottom : top; y + dy >= top && y + dy <= bottom;
+         y += step)
+        memmove(shadow + y * cols + to, shadow + (y + dy) * cols + dx + to,
+                width * sizeof(chtype));
+
+    if (headless)
+        return;
+
+    /* let the library scroll whole lines, so that the port can move
+       them on the screen; then restore the ones that scrolled in */
+
+    if (!dx && !left && right == cols - 1 && cols == COLS &&
+        bottom < LINES && wmove(stdscr, top, 0) == OK &&
+        wsetscrreg(stdscr, top, bottom) == OK)
+    {
+        scrollok(stdscr, TRUE);
+        wscrl(stdscr, dy);
+        scrollok(stdscr, FALSE);
+        wsetscrreg(stdscr, 0, LINES - 1);
+    }
+
+    for (y = top; y <= bottom; y++)
+        show(y, left, right - left + 1);
+}
+
+/* wait until ms milliseconds into the recording; FALSE on 'q' */
+
+static bool wait_until(unsigned long ms)
+{
+    while (!fast && clock_ms < ms)
+    {
+        unsigned long step = (ms - clock_ms > 50) ? 50 : ms - clock_ms;
+
+        if (wgetch(input) == 'q')
+            return FALSE;
+
+        napms((int)step);
+        clock_ms += step;
+    }
+
+    clock_ms = ms;
+
+    return TRUE;
+}
+
+static void print_screen(void)
+{
+    int y, x;
+
+    for (y = 0; y < lines; y++)
+    {
+        int end = cols;
+
+        while (end && ((shadow[y * cols + end - 1] & A_CHARTEXT) == ' ' ||
+               !(shadow[y * cols + end - 1] & A_CHARTEXT)))
+            end--;
+
+        for (x = 0; x < end; x++)
+        {
+            chtype c = shadow[y * cols + x] & A_CHARTEXT;
+
+            putchar((c >= ' ' && c < 0x7f) ? (int)c : (c ? '?' : ' '));
+        }
+
+        putchar('\n');
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long when = 0;
+    clock_t start;
+    char magic[4];
+    bool stopped = FALSE;
+    int c, i, cursor = -1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (!strcmp(argv[i], "-f"))
+            fast = TRUE;
+        else if (!strcmp(argv[i], "-n"))
+            headless = fast = TRUE;
+        else if (!strcmp(argv[i], "-k"))
+            listkeys = TRUE;
+        else
+            break;
+    }
+
+    if (i != argc - 1)
+    {
+        fprintf(stderr, "usage: replay [-f] [-n] [-k] file\n");
+        return 1;
+    }
+
+    rec = fopen(argv[i], "rb");
+    if (!rec)
+    {
+        perror(argv[i]);
+        return 1;
+    }
+
+    if (fread(magic, 4, 1, rec) != 1 || memcmp(magic, "PDCr", 4) ||
+        getc(rec) != 1 || (chsize = getc(rec)) != (int)sizeof(chtype))
+    {
+        fprintf(stderr, "replay: %s isn't a recording this build can "
+                "play\n", argv[i]);
+        return 1;
+    }
+
+    if (!headless)
+    {
+#ifdef XCURSES
+        Xinitscr(argc, argv);
+#else
+        initscr();
+#endif
+        if (has_colors())
+            start_color();
+
+        noecho();
+
+        input = newpad(1, 1);
+        nodelay(input, TRUE);
+    }
+
+    start = clock();
+
+    while (!stopped && (c = getc(rec)) != EOF)
+    {
+        int y, x, n;
+
+        switch (c)
+        {
+        case 'S':
+            y = (int)get_num();
+            x = (int)get_num();
+            new_size(y, x);
+            break;
+        case 'D':
+        case 'R':
+            y = (int)get_num();
+            x = (int)get_num();
+            n = (int)get_num();
+            cells_at(y, x, n, c == 'R');
+            break;
+        case 'M':
+            {
+                int top = (int)get_num(), left = (int)get_num();
+                int bottom = (int)get_num(), right = (int)get_num();
+                int dy = (int)get_signed(), dx = (int)get_signed();
+
+                move_rect(top, left, bottom, right, dy, dx);
+            }
+            break;
+        case 'F':
+            when += get_num();
+            y = (int)get_num();
+            x = (int)get_num();
+            n = (int)get_num();
+            frames++;
+
+            if (!headless)
+            {
+                if (y < LINES && x < COLS)
+                    move(y, x);
+
+                if (n != cursor)
+                    curs_set(cursor = n);
+
+                if (!wait_until(when) || (fast && wgetch(input) == 'q'))
+                    stopped = TRUE;
+
+                refresh();
+            }
+            break;
+        case 'K':
+            when += get_num();
+            n = (int)get_num();
+            keys++;
+
+            if (headless && listkeys)
+                printf("%8lu ms  %s\n", when, keyname(n));
+            break;
+        default:
+            stopped = TRUE;
+        }
+    }
+
+    if (!headless)
+    {
+        if (!fast && !stopped)
+        {
+            nodelay(input, FALSE);
+            wgetch(input);
+        }
+
+        delwin(input);
+        endwin();
+    }
+    else
+        print_screen();
+
+    if (fast)
+    {
+        double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        printf("%ld frames, %ld cells, %ld keys, %lu ms recorded; "
+               "%.3f s CPU", frames, cells, keys, when, secs);
+
+        if (secs > 0)
+            printf(", %.0f frames/s", frames / secs);
+
+        putchar('\n');
+    }
+
+    fclose(rec);
+    free(shadow);
+
+    return 0;
+}
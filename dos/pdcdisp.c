@@ -22,11 +22,11 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 {
     attr_t sysattrs;
     int j;
-    short fore, back;
+    int fore, back;
     unsigned char mapped_attr;
 
     sysattrs = SP->termattrs;
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    PDC_cell_colors(attr, &fore, &back);
 
     if (attr & A_BOLD)
         fore |= 8;
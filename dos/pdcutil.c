@@ -13,6 +13,13 @@ void PDC_beep(void)
     PDCINT(0x10, regs);
 }
 
+/* BIOS ticks come about every 55 ms */
+
+unsigned long PDC_ms_count(void)
+{
+    return getdosmemdword(0x46c) * 55;
+}
+
 void PDC_napms(int ms)
 {
     PDCREGS regs;
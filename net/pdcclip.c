@@ -0,0 +1,128 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*man-start**************************************************************
+
+clipboard
+---------
+
+### Synopsis
+
+    int PDC_getclipboard(char **contents, long *length);
+    int PDC_setclipboard(const char *contents, long length);
+    int PDC_freeclipboard(char *contents);
+    int PDC_clearclipboard(void);
+    int PDC_requestclipboard(void);
+    int PDC_pollclipboard(char **contents, long *length);
+
+### Description
+
+   PDC_getclipboard() gets the textual contents of the system's
+   clipboard. This function returns the contents of the clipboard in the
+   contents argument. It is the responsibility of the caller to free the
+   memory returned, via PDC_freeclipboard(). The length of the clipboard
+   contents is returned in the length argument.
+
+   PDC_setclipboard copies the supplied text into the system's
+   clipboard, emptying the clipboard prior to the copy.
+
+   PDC_clearclipboard() clears the internal clipboard.
+
+   PDC_requestclipboard() starts fetching the clipboard contents without
+   waiting for them to arrive. PDC_pollclipboard() returns
+   PDC_CLIP_PENDING while that request is still in flight; once it has
+   completed, it returns the contents just as PDC_getclipboard() does.
+   Here the clipboard is always available immediately, so
+   PDC_requestclipboard() does nothing, and PDC_pollclipboard() is
+   equivalent to PDC_getclipboard().
+
+   The clipboard is kept by the application, not shared with the
+   viewer's system.
+
+### Return Values
+
+    indicator of success/failure of call.
+    PDC_CLIP_SUCCESS        the call was successful
+    PDC_CLIP_MEMORY_ERROR   unable to allocate sufficient memory for
+                            the clipboard contents
+    PDC_CLIP_EMPTY          the clipboard contains no text
+    PDC_CLIP_ACCESS_ERROR   no clipboard support
+   PDC_CLIP_PENDING        a requested transfer has not yet completed
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_getclipboard            -       -       -
+    PDC_setclipboard            -       -       -
+    PDC_freeclipboard           -       -       -
+    PDC_clearclipboard          -       -       -
+    PDC_requestclipboard        -       -       -
+    PDC_pollclipboard           -       -       -
+
+**man-end****************************************************************/
+
+/* clipboard contents, NULL if none set */
+
+static char *pdc_clipboard = NULL;
+static long pdc_cliplen = 0;
+
+int PDC_getclipboard(char **contents, long *length)
+{
+    PDC_LOG(("PDC_getclipboard() - called\n"));
+
+    if (!pdc_clipboard)
+        return PDC_CLIP_EMPTY;
+
+    *contents = malloc(pdc_cliplen + 1);
+    if (!*contents)
+        return PDC_CLIP_MEMORY_ERROR;
+
+    memcpy(*contents, pdc_clipboard, pdc_cliplen + 1);
+    *length = pdc_cliplen;
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_setclipboard(const char *contents, long length)
+{
+    PDC_LOG(("PDC_setclipboard() - called\n"));
+
+    PDC_clearclipboard();
+
+    if (contents)
+    {
+        pdc_clipboard = malloc(length + 1);
+        if (!pdc_clipboard)
+            return PDC_CLIP_MEMORY_ERROR;
+
+        memcpy(pdc_clipboard, contents, length);
+        pdc_clipboard[length] = '\0';
+        pdc_cliplen = length;
+    }
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_freeclipboard(char *contents)
+{
+    PDC_LOG(("PDC_freeclipboard() - called\n"));
+
+    free(contents);
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_clearclipboard(void)
+{
+    PDC_LOG(("PDC_clearclipboard() - called\n"));
+
+    free(pdc_clipboard);
+
+    pdc_clipboard = NULL;
+    pdc_cliplen = 0;
+
+    return PDC_CLIP_SUCCESS;
+}
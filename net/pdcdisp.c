@@ -0,0 +1,195 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+/* The viewer draws the alternate character set from its own acs_map[],
+   so cells go out as they are, with A_ALTCHARSET; this is filled in by
+   PDC_scr_open() */
+
+chtype acs_map[128];
+
+#define _MINRUN 8       /* repeats shorter than this are sent as-is */
+
+/* The colors last sent for each pair; -2 if not sent yet */
+
+static short sent_pair[PDC_COLOR_PAIRS][2];
+
+static int cury, curx;                      /* as given to PDC_gotoyx() */
+static int sent_y, sent_x, sent_vis;        /* as last sent */
+static bool changed = FALSE;                /* sent since the last frame */
+
+/* Make the next frame resend everything the viewer keeps */
+
+void PDC_net_forget(void)
+{
+    int i;
+
+    for (i = 0; i < PDC_COLOR_PAIRS; i++)
+        sent_pair[i][0] = sent_pair[i][1] = -2;
+
+    sent_y = sent_x = sent_vis = -1;
+}
+
+/* Send the definitions of any pairs in the run that the viewer doesn't
+   have, or has with other colors */
+
+static void _send_pairs(int len, const chtype *srcp)
+{
+    int i, last = -1;
+
+    if (!SP->color_started)
+        return;
+
+    for (i = 0; i < len; i++)
+    {
+        int pair, fg = -1, bg = -1;
+
+#ifdef A_RGB_COLOR
+        if (srcp[i] & A_RGB_COLOR)
+            continue;
+#endif
+        pair = PAIR_NUMBER(srcp[i]);
+
+        if (pair == last)
+            continue;
+
+        last = pair;
+
+        extended_pair_content(pair, &fg, &bg);
+
+        if (fg != sent_pair[pair][0] || bg != sent_pair[pair][1])
+        {
+            sent_pair[pair][0] = (short)fg;
+            sent_pair[pair][1] = (short)bg;
+
+            PDC_net_put('P');
+            PDC_net_num(pair);
+            PDC_net_signed(fg);
+            PDC_net_signed(bg);
+        }
+    }
+}
+
+/* length of the run of identical cells at the start of cells */
+
+static int _run(const chtype *cells, int len)
+{
+    int n = 1;
+
+    while (n < len && cells[n] == cells[0])
+        n++;
+
+    return n;
+}
+
+/* position hardware cursor at (y, x) */
+
+void PDC_gotoyx(int row, int col)
+{
+    PDC_LOG(("PDC_gotoyx() - called: row %d col %d\n", row, col));
+
+    cury = row;
+    curx = col;
+}
+
+/* update the given physical line to look like the corresponding line in
+   curscr -- literal cells, with long repeats collapsed */
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+    int i = 0, j, n = 0;
+
+    PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
+
+    if (pdc_viewer == -1)
+        return;
+
+    _send_pairs(len, srcp);
+
+    while (i < len)
+    {
+        int start = i;
+
+        while (i < len && (n = _run(srcp + i, len - i)) < _MINRUN)
+            i += n;
+
+        if (i > start)
+        {
+            PDC_net_put('D');
+            PDC_net_num(lineno);
+            PDC_net_num(x + start);
+            PDC_net_num(i - start);
+
+            for (j = start; j < i; j++)
+                PDC_net_cell(srcp[j]);
+        }
+
+        if (i < len)
+        {
+            PDC_net_put('R');
+            PDC_net_num(lineno);
+            PDC_net_num(x + i);
+            PDC_net_num(n);
+            PDC_net_cell(srcp[i]);
+
+            i += n;
+        }
+    }
+
+    changed = TRUE;
+}
+
+/* The PDC_move_rect hook: the viewer moves the cells itself, so a
+   scroll costs one message instead of a screenful */
+
+int PDC_net_move(int top, int left, int bottom, int right, int dy, int dx)
+{
+    if (pdc_viewer != -1)
+    {
+        PDC_net_put('M');
+        PDC_net_num(top);
+        PDC_net_num(left);
+        PDC_net_num(bottom);
+        PDC_net_num(right);
+        PDC_net_signed(dy);
+        PDC_net_signed(dx);
+
+        changed = TRUE;
+    }
+
+    return OK;
+}
+
+/* End the frame, if anything's changed, and send it */
+
+void PDC_net_frame(void)
+{
+    if (changed || cury != sent_y || curx != sent_x ||
+        SP->visibility != sent_vis)
+    {
+        sent_y = cury;
+        sent_x = curx;
+        sent_vis = SP->visibility;
+        changed = FALSE;
+
+        PDC_net_put('F');
+        PDC_net_num(sent_y);
+        PDC_net_num(sent_x);
+        PDC_net_num(sent_vis);
+    }
+
+    PDC_net_flush();
+}
+
+/* Between frames, also take a new viewer, and bring it, or one that's
+   caught up after falling behind, up to date; an application that
+   never calls getch() still serves them */
+
+void PDC_doupdate(void)
+{
+    PDC_net_frame();
+    PDC_net_poll();
+
+    if (PDC_net_joined())
+        PDC_net_welcome();
+}
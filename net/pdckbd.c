@@ -0,0 +1,108 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+void PDC_set_keyboard_binary(bool on)
+{
+    PDC_LOG(("PDC_set_keyboard_binary() - called\n"));
+}
+
+/* check if a key or mouse event is waiting */
+
+bool PDC_check_key(void)
+{
+    return PDC_net_poll();
+}
+
+/* Bring a newly connected viewer up to date: the settings it keeps,
+   then the whole screen, as last drawn. If it's not the size the
+   application thinks, that's reported as a resize. This runs from
+   PDC_doupdate() as well as PDC_get_key(), so it can't go through
+   doupdate() itself. */
+
+void PDC_net_welcome(void)
+{
+    int y;
+
+    PDC_LOG(("PDC_net_welcome() - called\n"));
+
+    PDC_net_forget();
+    PDC_net_palette();
+    PDC_net_title();
+    PDC_mouse_set();
+
+    for (y = 0; y < SP->lines; y++)
+        PDC_transform_line(y, 0, SP->cols, SP->lastscr->_y[y]);
+
+    PDC_net_frame();
+
+    if (SP->lines != pdc_vlines || SP->cols != pdc_vcols)
+        PDC_net_resized();
+}
+
+/* return the next available key or mouse event */
+
+int PDC_get_key(void)
+{
+    PDC_NETEVENT ev;
+
+    if (PDC_net_joined())
+        PDC_net_welcome();
+
+    if (!PDC_net_next(&ev))
+        return -1;
+
+    SP->key_modifiers = ev.modifiers;
+    SP->key_code = ev.key_code;
+
+    if (ev.key == KEY_MOUSE)
+        SP->mouse_status = ev.mouse;
+    else if (ev.key == KEY_RESIZE)
+    {
+        if (SP->resized)
+            return -1;
+
+        SP->resized = TRUE;
+    }
+
+    return ev.key;
+}
+
+/* discard any pending keyboard or mouse input -- this is the core
+   routine for flushinp() */
+
+void PDC_flushinp(void)
+{
+    PDC_NETEVENT ev;
+
+    PDC_LOG(("PDC_flushinp() - called\n"));
+
+    PDC_net_poll();
+
+    while (PDC_net_next(&ev))
+        ;
+}
+
+bool PDC_has_mouse(void)
+{
+    return TRUE;
+}
+
+/* the viewer only reports the mouse events asked for */
+
+int PDC_mouse_set(void)
+{
+    if (pdc_viewer != -1)
+    {
+        PDC_net_put('E');
+        PDC_net_num(SP->_trap_mbe);
+        PDC_net_flush();
+    }
+
+    return OK;
+}
+
+int PDC_modifiers_set(void)
+{
+    return OK;
+}
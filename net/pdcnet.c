@@ -0,0 +1,653 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+#define _DEFAULT_ADDR "localhost:7001"
+#define _HELLO_MS 5000      /* time allowed for a viewer's greeting */
+#define _BYE_MS 1000        /* time allowed for the last output */
+#define _OUTMAX 0x100000    /* unsent output before a viewer is behind */
+#define _QUEUE 64           /* events waiting for PDC_get_key() */
+
+/* The application listens, and serves one viewer at a time; output
+   while there's none is dropped. Nothing waits on the viewer: its
+   greeting is read as it arrives, and output it hasn't taken yet is
+   kept, up to _OUTMAX. Past that, output is dropped until it catches
+   up, and then it's brought up to date as if it had just joined. */
+
+int pdc_viewer = -1;
+int pdc_vlines = 25, pdc_vcols = 80, pdc_vcolors = 0;
+chtype pdc_vattrs = 0;
+
+static int listener = -1;
+static char *unix_path = NULL;      /* to remove at the end */
+static int pending = -1;            /* accepted, greeting not yet in */
+static unsigned long pending_since;
+static bool joined = FALSE;         /* a new viewer needs the screen */
+static bool behind = FALSE;         /* output dropped until caught up */
+
+static unsigned char *outbuf = NULL;    /* messages not yet sent */
+static size_t outlen = 0, outsize = 0;
+
+static unsigned char inbuf[1024];   /* received, not yet parsed */
+static size_t inlen = 0, inpos = 0;
+static bool inshort;                /* ran out mid-message */
+
+static PDC_NETEVENT queue[_QUEUE];
+static int qhead = 0, qcount = 0;
+
+/* Open the listening socket. addr is a path, if it has a slash in it;
+   otherwise "port" (on localhost), "host:port", or ":port" (on all
+   interfaces). */
+
+static int _listen(const char *addr)
+{
+    struct addrinfo hints, *res, *ai;
+    char host[256];
+    const char *port = strrchr(addr, ':');
+    int fd = -1, on = 1;
+
+    if (strchr(addr, '/'))
+    {
+        struct sockaddr_un sa;
+        struct stat st;
+
+        if (strlen(addr) >= sizeof(sa.sun_path))
+            return -1;
+
+        /* a socket left over from an earlier run */
+
+        if (stat(addr, &st) == 0 && S_ISSOCK(st.st_mode))
+            unlink(addr);
+
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strcpy(sa.sun_path, addr);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1)
+            return -1;
+
+        if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) == -1 ||
+            listen(fd, 1) == -1)
+        {
+            close(fd);
+            return -1;
+        }
+
+        unix_path = malloc(strlen(addr) + 1);
+        if (unix_path)
+            strcpy(unix_path, addr);
+
+        return fd;
+    }
+
+    if (port)
+    {
+        size_t len = port - addr;
+
+        if (len >= sizeof(host))
+            return -1;
+
+        memcpy(host, addr, len);
+        host[len] = '\0';
+        port++;
+    }
+    else
+    {
+        strcpy(host, "localhost");
+        port = addr;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (getaddrinfo(*host ? host : NULL, port, &hints, &res))
+        return -1;
+
+    for (ai = res; ai; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd == -1)
+            continue;
+
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (void *)&on, sizeof(on));
+
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+            listen(fd, 1) == 0)
+            break;
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    return fd;
+}
+
+/* Reading messages: each _get_*() sets inshort, instead of reading
+   past what's arrived */
+
+static int _get_byte(void)
+{
+    if (inpos < inlen)
+        return inbuf[inpos++];
+
+    inshort = TRUE;
+    return 0;
+}
+
+static unsigned long _get_num(void)
+{
+    unsigned long n = 0;
+    int c, shift = 0;
+
+    do
+    {
+        c = _get_byte();
+
+        if (shift < (int)sizeof(unsigned long) * 8)
+            n |= (unsigned long)(c & 0x7f) << shift;
+
+        shift += 7;
+    } while ((c & 0x80) && !inshort);
+
+    return n;
+}
+
+static long _get_signed(void)
+{
+    unsigned long n = _get_num();
+
+    return (n & 1) ? -(long)(n >> 1) - 1 : (long)(n >> 1);
+}
+
+static chtype _get_cell(void)
+{
+    chtype ch = 0;
+    int i;
+
+    for (i = 0; i < (int)sizeof(chtype); i++)
+        ch |= (chtype)_get_byte() << (8 * i);
+
+    return ch;
+}
+
+/* Drop the viewer; keys it sent before it went are kept */
+
+static void _hangup(void)
+{
+    PDC_LOG(("_hangup() - called\n"));
+
+    if (pdc_viewer != -1)
+        close(pdc_viewer);
+
+    pdc_viewer = -1;
+    inlen = outlen = 0;
+    joined = behind = FALSE;
+}
+
+/* Drop a connection that hasn't finished its greeting */
+
+static void _reject(void)
+{
+    PDC_LOG(("_reject() - called\n"));
+
+    if (pending != -1)
+        close(pending);
+
+    pending = -1;
+    inlen = 0;
+}
+
+/* Read what's arrived from fd, waiting up to ms for something; FALSE
+   if the other end has gone */
+
+static bool _fill(int fd, int ms)
+{
+    struct pollfd pfd;
+    ssize_t got;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    if (inlen == sizeof(inbuf) || poll(&pfd, 1, ms) <= 0)
+        return TRUE;
+
+    got = read(fd, inbuf + inlen, sizeof(inbuf) - inlen);
+
+    if (got > 0)
+        inlen += got;
+    else if (!got || (errno != EINTR && errno != EAGAIN &&
+                      errno != EWOULDBLOCK))
+        return FALSE;
+
+    return TRUE;
+}
+
+/* Send what the viewer will take, waiting up to ms each time it won't
+   take more; the rest stays in outbuf */
+
+static void _send(int ms)
+{
+    struct pollfd pfd;
+    size_t sent = 0;
+
+    pfd.fd = pdc_viewer;
+    pfd.events = POLLOUT;
+
+    while (pdc_viewer != -1 && sent < outlen)
+    {
+        ssize_t n = send(pdc_viewer, outbuf + sent, outlen - sent,
+                         MSG_NOSIGNAL);
+
+        if (n > 0)
+            sent += n;
+        else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (poll(&pfd, 1, ms) <= 0)
+                break;
+        }
+        else if (n == -1 && errno != EINTR)
+            _hangup();
+    }
+
+    if (pdc_viewer != -1 && sent)
+    {
+        memmove(outbuf, outbuf + sent, outlen - sent);
+        outlen -= sent;
+    }
+}
+
+static void _queue(PDC_NETEVENT *ev)
+{
+    if (qcount < _QUEUE)
+    {
+        queue[(qhead + qcount) % _QUEUE] = *ev;
+        qcount++;
+    }
+}
+
+/* Turn complete messages from the viewer into events */
+
+static void _parse(void)
+{
+    size_t done = 0;
+
+    for (;;)
+    {
+        PDC_NETEVENT ev;
+        int type, i, lines, cols;
+
+        inpos = done;
+        inshort = FALSE;
+
+        if (inpos == inlen)
+            break;
+
+        memset(&ev, 0, sizeof(ev));
+
+        switch (type = _get_byte())
+        {
+        case 'K':
+            ev.key = (int)_get_num();
+            ev.key_code = (bool)_get_num();
+            ev.modifiers = _get_num();
+            break;
+        case 'M':
+            ev.key = KEY_MOUSE;
+            ev.key_code = TRUE;
+            ev.mouse.x = (int)_get_signed();
+            ev.mouse.y = (int)_get_signed();
+            ev.mouse.changes = (int)_get_num();
+            for (i = 0; i < 3; i++)
+                ev.mouse.button[i] = (short)_get_num();
+            ev.modifiers = _get_num();
+            break;
+        case 'Z':
+            lines = (int)_get_num();
+            cols = (int)_get_num();
+
+            if (!inshort)
+            {
+                pdc_vlines = lines;
+                pdc_vcols = cols;
+            }
+
+            ev.key = KEY_RESIZE;
+            ev.key_code = TRUE;
+            break;
+        default:
+            PDC_LOG(("_parse() - bad message %d\n", type));
+            _hangup();
+            return;
+        }
+
+        if (inshort)
+            break;
+
+        _queue(&ev);
+        done = inpos;
+    }
+
+    memmove(inbuf, inbuf + done, inlen - done);
+    inlen -= done;
+}
+
+/* Take a waiting viewer, if there is one, within ms. It opens with
+   "PDCn", the version, sizeof(chtype), and its lines, cols, COLORS and
+   termattrs; the application replies with the first three. A greeting
+   that's still coming is kept for the next call, until _HELLO_MS after
+   the connection. */
+
+static bool _accept(int ms)
+{
+    char magic[4];
+    unsigned long waited;
+    int version, chsize, lines, cols, colors, i;
+    chtype attrs;
+
+    if (pending == -1)
+    {
+        struct pollfd pfd;
+        int fd, on = 1;
+
+        pfd.fd = listener;
+        pfd.events = POLLIN;
+
+        if (listener == -1 || poll(&pfd, 1, ms) <= 0)
+            return FALSE;
+
+        fd = accept(listener, NULL, NULL);
+        if (fd == -1)
+            return FALSE;
+
+        /* frames are sent whole, so don't hold back the last packet */
+
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (void *)&on, sizeof(on));
+#ifdef SO_NOSIGPIPE
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, (void *)&on, sizeof(on));
+#endif
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        pending = fd;
+        pending_since = PDC_ms_count();
+        inlen = 0;
+    }
+
+    waited = PDC_ms_count() - pending_since;
+
+    if (waited >= _HELLO_MS)
+        ms = 0;
+    else if (ms < 0 || ms > (int)(_HELLO_MS - waited))
+        ms = (int)(_HELLO_MS - waited);
+
+    if (!_fill(pending, ms))
+    {
+        _reject();
+        return FALSE;
+    }
+
+    inpos = 0;
+    inshort = FALSE;
+
+    for (i = 0; i < 4; i++)
+        magic[i] = (char)_get_byte();
+
+    version = _get_byte();
+    chsize = _get_byte();
+    lines = (int)_get_num();
+    cols = (int)_get_num();
+    colors = (int)_get_num();
+    attrs = _get_cell();
+
+    if (inshort)
+    {
+        if (PDC_ms_count() - pending_since >= _HELLO_MS)
+            _reject();
+
+        return FALSE;
+    }
+
+    if (memcmp(magic, "PDCn", 4) || version != PDC_NET_VERSION ||
+        chsize != (int)sizeof(chtype) || lines < 2 || cols < 2)
+    {
+        _reject();
+        return FALSE;
+    }
+
+    pdc_viewer = pending;
+    pending = -1;
+
+    memmove(inbuf, inbuf + inpos, inlen - inpos);
+    inlen -= inpos;
+
+    pdc_vlines = lines;
+    pdc_vcols = cols;
+    pdc_vcolors = colors;
+    pdc_vattrs = attrs;
+
+    for (i = 0; i < 4; i++)
+        PDC_net_put("PDCn"[i]);
+
+    PDC_net_put(PDC_NET_VERSION);
+    PDC_net_put((int)sizeof(chtype));
+    PDC_net_flush();
+
+    if (pdc_viewer == -1)
+        return FALSE;
+
+    joined = TRUE;
+
+    return TRUE;
+}
+
+/* Listen where PDC_NET says, and wait for the first viewer */
+
+int PDC_net_open(void)
+{
+    const char *addr = getenv("PDC_NET");
+
+    if (!addr || !*addr)
+        addr = _DEFAULT_ADDR;
+
+    listener = _listen(addr);
+    if (listener == -1)
+    {
+        fprintf(stderr, "Could not listen on %s\n", addr);
+        return ERR;
+    }
+
+    fprintf(stderr, "Waiting for a viewer on %s\n", addr);
+
+    while (!_accept(-1))
+        ;
+
+    joined = FALSE;
+
+    return OK;
+}
+
+void PDC_net_close(void)
+{
+    _send(_BYE_MS);
+    _hangup();
+    _reject();
+
+    if (listener != -1)
+        close(listener);
+
+    listener = -1;
+
+    if (unix_path)
+    {
+        unlink(unix_path);
+        free(unix_path);
+        unix_path = NULL;
+    }
+
+    free(outbuf);
+    outbuf = NULL;
+    outsize = 0;
+}
+
+/* Send what's left, read anything that's come in, or take a new
+   viewer if there's none; TRUE if PDC_get_key() has something to
+   report */
+
+bool PDC_net_poll(void)
+{
+    if (pdc_viewer == -1)
+        _accept(0);
+    else
+    {
+        if (outlen || behind)
+            PDC_net_flush();
+
+        if (pdc_viewer != -1 && !qcount)
+        {
+            if (_fill(pdc_viewer, 0))
+                _parse();
+            else
+                _hangup();
+        }
+    }
+
+    return joined || qcount;
+}
+
+/* TRUE, once, after a new viewer has connected, or a slow one has
+   caught up */
+
+bool PDC_net_joined(void)
+{
+    bool was = joined;
+
+    joined = FALSE;
+
+    return was;
+}
+
+/* Report the viewer's size as a resize, as if it had sent one */
+
+void PDC_net_resized(void)
+{
+    PDC_NETEVENT ev;
+
+    memset(&ev, 0, sizeof(ev));
+
+    ev.key = KEY_RESIZE;
+    ev.key_code = TRUE;
+
+    _queue(&ev);
+}
+
+bool PDC_net_next(PDC_NETEVENT *ev)
+{
+    if (!qcount)
+        return FALSE;
+
+    *ev = queue[qhead];
+    qhead = (qhead + 1) % _QUEUE;
+    qcount--;
+
+    return TRUE;
+}
+
+/* Writing messages: they're collected until PDC_net_flush(), which
+   normally comes once per frame */
+
+void PDC_net_put(int c)
+{
+    if (pdc_viewer == -1 || behind)
+        return;
+
+    if (outlen == outsize)
+    {
+        size_t size = outsize ? outsize * 2 : 4096;
+        unsigned char *buf = realloc(outbuf, size);
+
+        /* the stream would be broken */
+
+        if (!buf)
+        {
+            _hangup();
+            return;
+        }
+
+        outbuf = buf;
+        outsize = size;
+    }
+
+    outbuf[outlen++] = (unsigned char)c;
+}
+
+void PDC_net_num(unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        PDC_net_put((int)(n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+
+    PDC_net_put((int)n);
+}
+
+void PDC_net_signed(long n)
+{
+    PDC_net_num((n < 0) ? -2 * (unsigned long)n - 1 : 2 * (unsigned long)n);
+}
+
+void PDC_net_cell(chtype ch)
+{
+    int i;
+
+    for (i = 0; i < (int)sizeof(chtype); i++, ch >>= 8)
+        PDC_net_put((int)(ch & 0xff));
+}
+
+/* Send what the viewer will take now. If too much is left, stop
+   adding to it; once it's all gone, the viewer gets everything again,
+   through PDC_get_key(), as if it were new. */
+
+void PDC_net_flush(void)
+{
+    _send(0);
+
+    if (pdc_viewer == -1)
+        return;
+
+    if (behind && !outlen)
+    {
+        PDC_LOG(("PDC_net_flush() - caught up\n"));
+
+        behind = FALSE;
+        joined = TRUE;
+    }
+    else if (!behind && outlen > _OUTMAX)
+    {
+        PDC_LOG(("PDC_net_flush() - viewer behind\n"));
+
+        behind = TRUE;
+    }
+}
@@ -0,0 +1,42 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/* The stream to and from the viewer; see README.md for the messages */
+
+#define PDC_NET_VERSION 1
+
+typedef struct
+{
+    int key;                    /* a key, KEY_MOUSE or KEY_RESIZE */
+    bool key_code;              /* key is a special key */
+    unsigned long modifiers;    /* PDC_KEY_MODIFIER_* at the time */
+    MOUSE_STATUS mouse;         /* for KEY_MOUSE */
+} PDC_NETEVENT;
+
+extern int pdc_viewer;          /* socket to the viewer, or -1 */
+extern int pdc_vlines, pdc_vcols;   /* the viewer's screen size */
+extern int pdc_vcolors;         /* the viewer's COLORS, or 0 if mono */
+extern chtype pdc_vattrs;       /* the viewer's termattrs */
+
+extern short pdc_color[PDC_MAXCOL][3];  /* palette, 0-1000 */
+
+extern int PDC_net_open(void);
+extern void PDC_net_close(void);
+extern bool PDC_net_poll(void);
+extern bool PDC_net_joined(void);
+extern bool PDC_net_next(PDC_NETEVENT *);
+extern void PDC_net_resized(void);
+extern void PDC_net_welcome(void);
+
+extern void PDC_net_put(int);
+extern void PDC_net_num(unsigned long);
+extern void PDC_net_signed(long);
+extern void PDC_net_cell(chtype);
+extern void PDC_net_flush(void);
+
+extern void PDC_net_forget(void);
+extern void PDC_net_frame(void);
+extern int PDC_net_move(int, int, int, int, int, int);
+extern void PDC_net_palette(void);
+extern void PDC_net_title(void);
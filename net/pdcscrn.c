@@ -0,0 +1,169 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+short pdc_color[PDC_MAXCOL][3];
+
+/* colors set by init_color(), which a new viewer must be told about */
+
+static unsigned long changed_colors[PDC_BLINK_WORDS(PDC_MAXCOL)];
+
+void PDC_scr_close(void)
+{
+    PDC_LOG(("PDC_scr_close() - called\n"));
+
+    PDC_net_flush();
+}
+
+void PDC_scr_free(void)
+{
+    PDC_net_close();
+}
+
+/* The same palette as the SDL ports, in init_color() units */
+
+static void _initialize_colors(void)
+{
+    int i, r, g, b;
+
+    for (i = 0; i < 8; i++)
+    {
+        pdc_color[i][0] = (i & COLOR_RED) ? 753 : 0;
+        pdc_color[i][1] = (i & COLOR_GREEN) ? 753 : 0;
+        pdc_color[i][2] = (i & COLOR_BLUE) ? 753 : 0;
+
+        pdc_color[i + 8][0] = (i & COLOR_RED) ? 1000 : 251;
+        pdc_color[i + 8][1] = (i & COLOR_GREEN) ? 1000 : 251;
+        pdc_color[i + 8][2] = (i & COLOR_BLUE) ? 1000 : 251;
+    }
+
+    /* 256-color xterm extended palette: 216 colors in a 6x6x6 color
+       cube, plus 24 shades of gray */
+
+    for (i = 16, r = 0; r < 6; r++)
+        for (g = 0; g < 6; g++)
+            for (b = 0; b < 6; b++, i++)
+            {
+                pdc_color[i][0] = r ? DIVROUND((r * 40 + 55) * 1000, 255) : 0;
+                pdc_color[i][1] = g ? DIVROUND((g * 40 + 55) * 1000, 255) : 0;
+                pdc_color[i][2] = b ? DIVROUND((b * 40 + 55) * 1000, 255) : 0;
+            }
+
+    for (i = 232; i < 256; i++)
+        pdc_color[i][0] = pdc_color[i][1] = pdc_color[i][2] =
+            DIVROUND(((i - 232) * 10 + 8) * 1000, 255);
+}
+
+/* open the physical screen -- wait for a viewer */
+
+int PDC_scr_open(void)
+{
+    int i;
+
+    PDC_LOG(("PDC_scr_open() - called\n"));
+
+    for (i = 0; i < 128; i++)
+        acs_map[i] = PDC_ACS(i);
+
+    _initialize_colors();
+
+    if (PDC_net_open() == ERR)
+        return ERR;
+
+    PDC_net_forget();
+
+    SP->mono = !pdc_vcolors;
+    SP->orig_attr = FALSE;
+    SP->mouse_wait = PDC_CLICK_PERIOD;
+    SP->audible = TRUE;
+    SP->termattrs = pdc_vattrs;
+
+    PDC_move_rect = PDC_net_move;
+
+    return OK;
+}
+
+/* the core of resize_term() -- ask the viewer for the new size; if it
+   can't manage that, it reports the size it could, as a resize */
+
+int PDC_resize_screen(int nlines, int ncols)
+{
+    if (nlines && ncols)
+    {
+        pdc_vlines = nlines;
+        pdc_vcols = ncols;
+
+        PDC_net_put('Z');
+        PDC_net_num(nlines);
+        PDC_net_num(ncols);
+        PDC_net_flush();
+    }
+
+    return OK;
+}
+
+void PDC_reset_prog_mode(void)
+{
+    PDC_LOG(("PDC_reset_prog_mode() - called.\n"));
+}
+
+void PDC_reset_shell_mode(void)
+{
+    PDC_LOG(("PDC_reset_shell_mode() - called.\n"));
+}
+
+void PDC_restore_screen_mode(int i)
+{
+}
+
+void PDC_save_screen_mode(int i)
+{
+}
+
+bool PDC_can_change_color(void)
+{
+    return TRUE;
+}
+
+int PDC_color_content(short color, short *red, short *green, short *blue)
+{
+    *red = pdc_color[color][0];
+    *green = pdc_color[color][1];
+    *blue = pdc_color[color][2];
+
+    return OK;
+}
+
+static void _send_color(int color)
+{
+    PDC_net_put('C');
+    PDC_net_num(color);
+    PDC_net_num(pdc_color[color][0]);
+    PDC_net_num(pdc_color[color][1]);
+    PDC_net_num(pdc_color[color][2]);
+}
+
+int PDC_init_color(short color, short red, short green, short blue)
+{
+    pdc_color[color][0] = red;
+    pdc_color[color][1] = green;
+    pdc_color[color][2] = blue;
+
+    changed_colors[color / PDC_BLINK_BITS] |= 1UL << (color % PDC_BLINK_BITS);
+
+    _send_color(color);
+    PDC_net_flush();
+
+    return OK;
+}
+
+/* send a new viewer the colors that were changed */
+
+void PDC_net_palette(void)
+{
+    int i;
+
+    for (i = 0; i < PDC_MAXCOL; i++)
+        if (changed_colors[i / PDC_BLINK_BITS] & (1UL << (i % PDC_BLINK_BITS)))
+            _send_color(i);
+}
@@ -0,0 +1,129 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*man-start**************************************************************
+
+pdcsetsc
+--------
+
+### Synopsis
+
+    int PDC_set_blink(bool blinkon);
+    int PDC_set_bold(bool boldon);
+    int PDC_set_render_thread(bool on);
+    void PDC_set_title(const char *title);
+
+### Description
+
+   PDC_set_blink() toggles whether the A_BLINK attribute sets an actual
+   blink mode (TRUE), or sets the background color to high intensity
+   (FALSE). The default is platform-dependent (FALSE in most cases). It
+   returns OK if it could set the state to match the given parameter,
+   ERR otherwise.
+
+   PDC_set_bold() toggles whether the A_BOLD attribute selects an actual
+   bold font (TRUE), or sets the foreground color to high intensity
+   (FALSE). It returns OK if it could set the state to match the given
+   parameter, ERR otherwise.
+
+   PDC_set_render_thread() toggles whether drawing is done on a thread
+   of its own (TRUE), or by doupdate() itself (FALSE, the default). With
+   the thread, doupdate() just hands over the changes, and returns
+   without waiting for the display; if the thread falls behind, the
+   updates it hasn't drawn yet are merged into one. Only the SDL2 port
+   supports this. It returns OK if it could set the state to match the
+   given parameter, ERR otherwise.
+
+   PDC_set_title() sets the title of the window in which the curses
+   program is running. This function may not do anything on some
+   platforms.
+
+   With a remote viewer, blink and bold are whatever the viewer uses;
+   these functions can't change them.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_set_blink               -       -       -
+    PDC_set_title               -       -       -
+    PDC_set_render_thread       -       -       -
+
+**man-end****************************************************************/
+
+static char *net_title = NULL;  /* for viewers that connect later */
+
+int PDC_curs_set(int visibility)
+{
+    int ret_vis;
+
+    PDC_LOG(("PDC_curs_set() - called: visibility=%d\n", visibility));
+
+    ret_vis = SP->visibility;
+
+    SP->visibility = visibility;
+
+    PDC_net_frame();
+
+    return ret_vis;
+}
+
+/* send the title to a new viewer */
+
+void PDC_net_title(void)
+{
+    size_t i, len;
+
+    if (!net_title)
+        return;
+
+    len = strlen(net_title);
+
+    PDC_net_put('T');
+    PDC_net_num(len);
+
+    for (i = 0; i < len; i++)
+        PDC_net_put((unsigned char)net_title[i]);
+}
+
+void PDC_set_title(const char *title)
+{
+    PDC_LOG(("PDC_set_title() - called:<%s>\n", title));
+
+    free(net_title);
+
+    net_title = malloc(strlen(title) + 1);
+    if (!net_title)
+        return;
+
+    strcpy(net_title, title);
+
+    PDC_net_title();
+    PDC_net_flush();
+}
+
+int PDC_set_blink(bool blinkon)
+{
+    if (!SP)
+        return ERR;
+
+    if (SP->color_started)
+        COLORS = pdc_vcolors;
+
+    return (!!(SP->termattrs & A_BLINK) == !!blinkon) ? OK : ERR;
+}
+
+int PDC_set_bold(bool boldon)
+{
+    if (!SP)
+        return ERR;
+
+    return (!!(SP->termattrs & A_BOLD) == !!boldon) ? OK : ERR;
+}
+
+int PDC_set_render_thread(bool on)
+{
+    return on ? ERR : OK;
+}
@@ -0,0 +1,39 @@
+/* PDCurses */
+
+#include "pdcnet.h"
+
+#include <poll.h>
+#include <sys/time.h>
+
+void PDC_beep(void)
+{
+    PDC_LOG(("PDC_beep() - called\n"));
+
+    PDC_net_put('B');
+    PDC_net_flush();
+}
+
+unsigned long PDC_ms_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000UL + tv.tv_usec / 1000;
+}
+
+void PDC_napms(int ms)
+{
+    struct pollfd fd;
+
+    PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
+
+    fd.fd = -1;
+    fd.events = 0;
+    poll(&fd, 1, ms);
+}
+
+const char *PDC_sysname(void)
+{
+    return "Net";
+}
@@ -0,0 +1,584 @@
+/* viewer -- show an application that uses PDCurses for the net port
+
+   usage: viewer [address]
+
+   address is where the application is listening: a path, for a Unix-
+   domain socket; otherwise "host:port", or just "port" on localhost.
+   The default is localhost:7001. The viewer is itself a curses program;
+   build it with the SDL2 port (see the "viewer" target there), and with
+   the same chtype size (CHTYPE_64) as the application.
+
+   Keys and mouse events go to the application; resizing the window
+   resizes its screen. The viewer ends when the application does. */
+
+#include <curses.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+#define VERSION 1
+
+static int sock = -1;
+static WINDOW *input;       /* a pad, so reading keys doesn't refresh */
+
+static unsigned char inbuf[65536];  /* received, not yet applied */
+static size_t inlen, inpos;
+static bool inshort;                /* ran out mid-message */
+
+static unsigned char outbuf[64];    /* one message to send */
+static size_t outlen;
+
+static chtype *shadow;      /* the application's screen */
+static int lines, cols, cursor = -1;
+
+static int connect_to(const char *addr)
+{
+    struct addrinfo hints, *res, *ai;
+    char host[256];
+    const char *port = strrchr(addr, ':');
+    int fd = -1, on = 1;
+
+    if (strchr(addr, '/'))
+    {
+        struct sockaddr_un sa;
+
+        if (strlen(addr) >= sizeof(sa.sun_path))
+            return -1;
+
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strcpy(sa.sun_path, addr);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd != -1 && connect(fd, (struct sockaddr *)&sa, sizeof(sa)))
+        {
+            close(fd);
+            fd = -1;
+        }
+
+        return fd;
+    }
+
+    if (port && port - addr < (int)sizeof(host))
+    {
+        memcpy(host, addr, port - addr);
+        host[port - addr] = '\0';
+        port++;
+    }
+    else
+    {
+        strcpy(host, "localhost");
+        port = addr;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(host, port, &hints, &res))
+        return -1;
+
+    for (ai = res; ai; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd == -1)
+            continue;
+
+        if (!connect(fd, ai->ai_addr, ai->ai_addrlen))
+            break;
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd != -1)
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (void *)&on, sizeof(on));
+
+    return fd;
+}
+
+/* sending */
+
+static void put_byte(int c)
+{
+    if (outlen < sizeof(outbuf))
+        outbuf[outlen++] = (unsigned char)c;
+}
+
+static void put_num(unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        put_byte((int)(n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+
+    put_byte((int)n);
+}
+
+static void put_signed(long n)
+{
+    put_num((n < 0) ? -2 * (unsigned long)n - 1 : 2 * (unsigned long)n);
+}
+
+static void put_cell(chtype ch)
+{
+    int i;
+
+    for (i = 0; i < (int)sizeof(chtype); i++, ch >>= 8)
+        put_byte((int)(ch & 0xff));
+}
+
+static bool flush_out(void)
+{
+    size_t sent = 0;
+
+    while (sent < outlen)
+    {
+        ssize_t n = send(sock, outbuf + sent, outlen - sent, MSG_NOSIGNAL);
+
+        if (n > 0)
+            sent += n;
+        else if (n == -1 && errno != EINTR)
+            return FALSE;
+    }
+
+    outlen = 0;
+
+    return TRUE;
+}
+
+/* receiving: each get_*() sets inshort, instead of reading past what's
+   arrived */
+
+static int get_byte(void)
+{
+    if (inpos < inlen)
+        return inbuf[inpos++];
+
+    inshort = TRUE;
+    return 0;
+}
+
+static unsigned long get_num(void)
+{
+    unsigned long n = 0;
+    int c, shift = 0;
+
+    do
+    {
+        c = get_byte();
+
+        if (shift < (int)sizeof(unsigned long) * 8)
+            n |= (unsigned long)(c & 0x7f) << shift;
+
+        shift += 7;
+    } while ((c & 0x80) && !inshort);
+
+    return n;
+}
+
+static long get_signed(void)
+{
+    unsigned long n = get_num();
+
+    return (n & 1) ? -(long)(n >> 1) - 1 : (long)(n >> 1);
+}
+
+static chtype get_cell(void)
+{
+    chtype ch = 0;
+    int i;
+
+    for (i = 0; i < (int)sizeof(chtype); i++)
+        ch |= (chtype)get_byte() << (8 * i);
+
+    return ch;
+}
+
+/* wait up to ms for more to arrive; FALSE if the application's gone */
+
+static bool fill(int ms)
+{
+    struct pollfd pfd;
+    ssize_t got;
+
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+
+    if (inlen == sizeof(inbuf) || poll(&pfd, 1, ms) <= 0)
+        return TRUE;
+
+    got = read(sock, inbuf + inlen, sizeof(inbuf) - inlen);
+
+    if (got > 0)
+        inlen += got;
+    else if (!got || (errno != EINTR && errno != EAGAIN))
+        return FALSE;
+
+    return TRUE;
+}
+
+/* copy row y, columns x to x + n - 1, from the shadow to stdscr */
+
+static void show(int y, int x, int n)
+{
+    if (y >= LINES || x >= COLS)
+        return;
+
+    if (n > COLS - x)
+        n = COLS - x;
+
+    mvwaddchnstr(stdscr, y, x, shadow + y * cols + x, n);
+}
+
+static void new_size(void)
+{
+    lines = LINES;
+    cols = COLS;
+
+    free(shadow);
+    shadow = calloc((size_t)lines * cols, sizeof(chtype));
+    if (!shadow)
+    {
+        endwin();
+        fprintf(stderr, "viewer: out of memory\n");
+        exit(1);
+    }
+
+    erase();
+}
+
+/* the same as doupdate() does with the screen; cells with nothing to
+   take from keep what they show */
+
+static void move_rect(int top, int left, int bottom, int right,
+                      int dy, int dx)
+{
+    int to = (dx < 0) ? left - dx : left;
+    int width = right - left + 1 - abs(dx);
+    int y, step = (dy < 0) ? -1 : 1;
+
+    if (bottom >= lines || right >= cols || width <= 0)
+        return;
+
+    for (y = (dy < 0) ? bottom : top; y + dy >= top && y + dy <= bottom;
+         y += step)
+        memmove(shadow + y * cols + to, shadow + (y + dy) * cols + dx + to,
+                width * sizeof(chtype));
+
+    /* let curses scroll whole lines, so that the port can move them on
+       the screen; then restore the ones that scrolled in */
+
+    if (!dx && !left && right == cols - 1 && bottom < LINES &&
+        wmove(stdscr, top, 0) == OK &&
+        wsetscrreg(stdscr, top, bottom) == OK)
+    {
+        scrollok(stdscr, TRUE);
+        wscrl(stdscr, dy);
+        scrollok(stdscr, FALSE);
+        wsetscrreg(stdscr, 0, LINES - 1);
+    }
+
+    for (y = top; y <= bottom; y++)
+        show(y, left, right - left + 1);
+}
+
+static void cells_at(int y, int x, int n, bool repeat)
+{
+    chtype ch = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!i || !repeat)
+            ch = get_cell();
+
+        if (!inshort && y < lines && x + i < cols)
+            shadow[y * cols + x + i] = ch;
+    }
+
+    if (!inshort && y < lines && x < cols)
+        show(y, x, (x + n > cols) ? cols - x : n);
+}
+
+static void set_title(int len)
+{
+    char title[256];
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        int c = get_byte();
+
+        if (i < (int)sizeof(title) - 1)
+            title[i] = (char)c;
+    }
+
+    title[(len < (int)sizeof(title)) ? len : (int)sizeof(title) - 1] = 0;
+
+    if (!inshort)
+        PDC_set_title(title);
+}
+
+/* Apply the complete messages received. Cells arrive first; the frame
+   is shown when its F message comes. */
+
+static bool apply(void)
+{
+    size_t done = 0;
+
+    for (;;)
+    {
+        int c, y, x, n, a, b, d;
+
+        inpos = done;
+        inshort = FALSE;
+
+        if (inpos == inlen)
+            break;
+
+        switch (c = get_byte())
+        {
+        case 'D':
+        case 'R':
+            y = (int)get_num();
+            x = (int)get_num();
+            n = (int)get_num();
+
+            cells_at(y, x, n, c == 'R');
+            break;
+        case 'M':
+            y = (int)get_num();
+            x = (int)get_num();
+            a = (int)get_num();
+            b = (int)get_num();
+            n = (int)get_signed();
+            d = (int)get_signed();
+            if (!inshort)
+                move_rect(y, x, a, b, n, d);
+            break;
+        case 'P':
+            n = (int)get_num();
+            a = (int)get_signed();
+            b = (int)get_signed();
+            if (!inshort)
+            {
+                if (n)
+                    init_extended_pair(n, a, b);
+                else
+                    assume_default_colors(a, b);
+            }
+            break;
+        case 'C':
+            n = (int)get_num();
+            a = (int)get_num();
+            b = (int)get_num();
+            d = (int)get_num();
+            if (!inshort)
+                init_color((short)n, (short)a, (short)b, (short)d);
+            break;
+        case 'F':
+            y = (int)get_num();
+            x = (int)get_num();
+            n = (int)get_num();
+            if (!inshort)
+            {
+                if (n != cursor)
+                    curs_set(cursor = n);
+
+                if (y < LINES && x < COLS)
+                    move(y, x);
+
+                refresh();
+            }
+            break;
+        case 'B':
+            beep();
+            break;
+        case 'T':
+            n = (int)get_num();
+            if (!inshort)
+                set_title(n);
+            break;
+        case 'Z':
+            y = (int)get_num();
+            x = (int)get_num();
+            if (!inshort)
+            {
+                resize_term(y, x);
+                new_size();
+
+                /* tell the application if it didn't work out */
+
+                if (LINES != y || COLS != x)
+                {
+                    put_byte('Z');
+                    put_num(LINES);
+                    put_num(COLS);
+                    if (!flush_out())
+                        return FALSE;
+                }
+            }
+            break;
+        case 'E':
+            n = (int)get_num();
+            if (!inshort)
+                mouse_set((mmask_t)n);
+            break;
+        default:
+            return FALSE;
+        }
+
+        if (inshort)
+            break;
+
+        done = inpos;
+    }
+
+    /* a message is at most a line of cells, so this means garbage */
+
+    if (!done && inlen == sizeof(inbuf))
+        return FALSE;
+
+    memmove(inbuf, inbuf + done, inlen - done);
+    inlen -= done;
+
+    return TRUE;
+}
+
+static bool send_key(int key)
+{
+    if (key == KEY_RESIZE)
+    {
+        resize_term(0, 0);
+        new_size();
+
+        put_byte('Z');
+        put_num(LINES);
+        put_num(COLS);
+    }
+    else if (key == KEY_MOUSE)
+    {
+        int i;
+
+        request_mouse_pos();
+
+        put_byte('M');
+        put_signed(Mouse_status.x);
+        put_signed(Mouse_status.y);
+        put_num(Mouse_status.changes);
+        for (i = 0; i < 3; i++)
+            put_num(Mouse_status.button[i]);
+        put_num(PDC_get_key_modifiers());
+    }
+    else
+    {
+        put_byte('K');
+        put_num(key);
+        put_num(SP->key_code);
+        put_num(PDC_get_key_modifiers());
+    }
+
+    return flush_out();
+}
+
+/* the viewer's greeting: "PDCn", the version, sizeof(chtype), then the
+   screen size, COLORS and termattrs(); the application answers with
+   the first three */
+
+static bool hello(void)
+{
+    int i;
+
+    for (i = 0; i < 4; i++)
+        put_byte("PDCn"[i]);
+
+    put_byte(VERSION);
+    put_byte((int)sizeof(chtype));
+    put_num(LINES);
+    put_num(COLS);
+    put_num(has_colors() ? COLORS : 0);
+    put_cell(termattrs());
+
+    if (!flush_out())
+        return FALSE;
+
+    do
+    {
+        if (!fill(-1))
+            return FALSE;
+    } while (inlen < 6);
+
+    if (memcmp(inbuf, "PDCn", 4) || inbuf[4] != VERSION ||
+        inbuf[5] != sizeof(chtype))
+        return FALSE;
+
+    memmove(inbuf, inbuf + 6, inlen - 6);
+    inlen -= 6;
+
+    return TRUE;
+}
+
+int main(int argc, char **argv)
+{
+    const char *addr = (argc > 1) ? argv[1] : "localhost:7001";
+    bool ok;
+
+    sock = connect_to(addr);
+    if (sock == -1)
+    {
+        fprintf(stderr, "viewer: can't connect to %s\n", addr);
+        return 1;
+    }
+
+    initscr();
+    raw();
+    noecho();
+
+    if (has_colors())
+    {
+        start_color();
+        use_default_colors();
+    }
+
+    input = newpad(1, 1);
+    keypad(input, TRUE);
+    nodelay(input, TRUE);
+
+    new_size();
+
+    ok = hello();
+
+    while (ok)
+    {
+        int key;
+
+        while (ok && (key = wgetch(input)) != ERR)
+            ok = send_key(key);
+
+        ok = ok && fill(10) && apply();
+    }
+
+    delwin(input);
+    endwin();
+
+    free(shadow);
+    close(sock);
+
+    return 0;
+}
@@ -21,11 +21,11 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 
     char temp_line[256];
     int j;
-    short fore, back;
+    int fore, back;
     unsigned char mapped_attr;
     bool blink;
 
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    PDC_cell_colors(attr, &fore, &back);
     blink = (SP->termattrs & A_BLINK) && (attr & A_BLINK);
 
     if (blink)
@@ -104,7 +104,7 @@ void PDC_blink_text(void)
 
     for (i = 0; i < SP->lines; i++)
     {
-        const chtype *srcp = curscr->_y[i];
+        const chtype *srcp = SP->lastscr->_y[i];
 
         for (j = 0; j < SP->cols; j++)
             if (srcp[j] & A_BLINK)
@@ -11,6 +11,7 @@ pdcsetsc
 
     int PDC_set_blink(bool blinkon);
     int PDC_set_bold(bool boldon);
+    int PDC_set_render_thread(bool on);
     void PDC_set_title(const char *title);
 
 ### Description
@@ -26,6 +27,14 @@ pdcsetsc
    (FALSE). It returns OK if it could set the state to match the given
    parameter, ERR otherwise.
 
+   PDC_set_render_thread() toggles whether drawing is done on a thread
+   of its own (TRUE), or by doupdate() itself (FALSE, the default). With
+   the thread, doupdate() just hands over the changes, and returns
+   without waiting for the display; if the thread falls behind, the
+   updates it hasn't drawn yet are merged into one. Only the SDL2 port
+   supports this. It returns OK if it could set the state to match the
+   given parameter, ERR otherwise.
+
    PDC_set_title() sets the title of the window in which the curses
    program is running. This function may not do anything on some
    platforms.
@@ -34,6 +43,7 @@ pdcsetsc
                              X/Open  ncurses  NetBSD
     PDC_set_blink               -       -       -
     PDC_set_title               -       -       -
+    PDC_set_render_thread       -       -       -
 
 **man-end****************************************************************/
 
@@ -111,3 +121,8 @@ int PDC_set_bold(bool boldon)
 {
     return boldon ? ERR : OK;
 }
+
+int PDC_set_render_thread(bool on)
+{
+    return on ? ERR : OK;
+}
@@ -13,7 +13,7 @@ void PDC_beep(void)
     DosBeep(1380, 100);
 }
 
-ULONG PDC_ms_count(void)
+unsigned long PDC_ms_count(void)
 {
     ULONG now;
 
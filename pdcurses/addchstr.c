@@ -84,30 +84,36 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
     if (n == -1 || n > win->_maxx - x)
         n = win->_maxx - x;
 
-    minx = win->_firstch[y];
-    maxx = win->_lastch[y];
+    /* changed cells are marked a span at a time; a span runs on past
+       unchanged cells as long as it covers no more chunks than marking
+       each cell would */
+
+    minx = maxx = _NO_CHANGE;
 
     for (; n && *ch; n--, x++, ptr++, ch++)
     {
         if (*ptr != *ch)
         {
-            if (x < minx || minx == _NO_CHANGE)
+            if (minx != _NO_CHANGE && x / PDC_CHUNK > maxx / PDC_CHUNK + 1)
+            {
+                PDC_touch_span(win, y, minx, maxx);
+                minx = _NO_CHANGE;
+            }
+
+            if (minx == _NO_CHANGE)
                 minx = x;
 
-            if (x > maxx)
-                maxx = x;
+            maxx = x;
 
-            PDC_LOG(("y %d x %d minx %d maxx %d *ptr %x *ch"
-                     " %x firstch: %d lastch: %d\n",
-                     y, x, minx, maxx, *ptr, *ch,
-                     win->_firstch[y], win->_lastch[y]));
+            PDC_LOG(("y %d x %d minx %d maxx %d *ptr %x *ch %x\n",
+                     y, x, minx, maxx, *ptr, *ch));
 
             *ptr = *ch;
         }
     }
 
-    win->_firstch[y] = minx;
-    win->_lastch[y] = maxx;
+    if (minx != _NO_CHANGE)
+        PDC_touch_span(win, y, minx, maxx);
 
     return OK;
 }
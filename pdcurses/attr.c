@@ -68,16 +68,20 @@ attr
    wattroff() turns off the named attributes without affecting any other
    attributes; wattron() turns them on.
 
-   wcolor_set() sets the window color to the value of color_pair. opts
-   is unused.
+   wcolor_set() sets the window color to the value of color_pair.
 
    standout() is the same as attron(A_STANDOUT). standend() is the same
    as attrset(A_NORMAL); that is, it turns off all attributes.
 
    The attr_* and wattr_* functions are intended for use with the WA_*
    attributes. In PDCurses, these are the same as A_*, and there is no
-   difference in bevahior from the chtype-based functions. In all cases,
-   opts is unused.
+   difference in bevahior from the chtype-based functions.
+
+   As in ncurses, the opts argument of wcolor_set(), wattr_set() and
+   wchgat() may point to an int holding the color pair, which is then
+   used instead of the short argument; and wattr_get() stores the pair
+   in it, if given. This is how to reach pairs above 32767 (when built
+   with CHTYPE_64). Otherwise, opts should be NULL.
 
    wattr_get() retrieves the attributes and color pair for the specified
    window.
@@ -86,7 +90,7 @@ attr
    the current line of a given window, without changing the existing
    text, or alterting the window's attributes. An n of -1 extends the
    change to the edge of the window. The changes take effect
-   immediately. opts is unused.
+   immediately.
 
    wunderscore() turns on the A_UNDERLINE attribute; wunderend() turns
    it off. underscore() and underend() are the stdscr versions.
@@ -238,7 +242,8 @@ int wcolor_set(WINDOW *win, short color_pair, void *opts)
     if (!win)
         return ERR;
 
-    win->_attrs = (win->_attrs & ~A_COLOR) | COLOR_PAIR(color_pair);
+    win->_attrs = (win->_attrs & ~A_COLOR) |
+                  COLOR_PAIR(opts ? *(int *)opts : color_pair);
 
     return OK;
 }
@@ -263,6 +268,9 @@ int wattr_get(WINDOW *win, attr_t *attrs, short *color_pair, void *opts)
     if (color_pair)
         *color_pair = PAIR_NUMBER(win->_attrs);
 
+    if (opts)
+        *(int *)opts = PAIR_NUMBER(win->_attrs);
+
     return OK;
 }
 
@@ -308,7 +316,8 @@ int wattr_set(WINDOW *win, attr_t attrs, short color_pair, void *opts)
     if (!win)
         return ERR;
 
-    win->_attrs = (attrs & (A_ATTRIBUTES & ~A_COLOR)) | COLOR_PAIR(color_pair);
+    win->_attrs = (attrs & (A_ATTRIBUTES & ~A_COLOR)) |
+                  COLOR_PAIR(opts ? *(int *)opts : color_pair);
 
     return OK;
 }
@@ -330,7 +339,8 @@ int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
     if (!win)
         return ERR;
 
-    newattr = (attr & A_ATTRIBUTES) | COLOR_PAIR(color);
+    newattr = (attr & A_ATTRIBUTES) |
+              COLOR_PAIR(opts ? *(const int *)opts : color);
 
     startpos = win->_curx;
     endpos = ((n < 0) ? win->_maxx : min(startpos + n, win->_maxx)) - 1;
@@ -339,13 +349,7 @@ int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
     for (n = startpos; n <= endpos; n++)
         dest[n] = (dest[n] & A_CHARTEXT) | newattr;
 
-    n = win->_cury;
-
-    if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-        win->_firstch[n] = startpos;
-
-    if (endpos > win->_lastch[n])
-        win->_lastch[n] = endpos;
+    PDC_touch_span(win, win->_cury, startpos, endpos);
 
     PDC_sync(win);
 
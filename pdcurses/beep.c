@@ -39,6 +39,9 @@ int beep(void)
     if (!SP)
         return ERR;
 
+    if (SP->opaque->headless)
+        return OK;
+
     if (SP->audible)
         PDC_beep();
     else
@@ -173,12 +173,18 @@ int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
     win->_y[ymax][0] = bl;
     win->_y[ymax][xmax] = br;
 
-    for (i = 0; i <= ymax; i++)
+    /* only the edges changed, apart from the top and bottom lines */
+
+    PDC_touch_span(win, 0, 0, xmax);
+
+    for (i = 1; i < ymax; i++)
     {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = xmax;
+        PDC_touch_span(win, i, 0, 0);
+        PDC_touch_span(win, i, xmax, xmax);
     }
 
+    PDC_touch_span(win, ymax, 0, xmax);
+
     PDC_sync(win);
 
     return OK;
@@ -217,13 +223,7 @@ int whline(WINDOW *win, chtype ch, int n)
     for (n = startpos; n <= endpos; n++)
         dest[n] = ch;
 
-    n = win->_cury;
-
-    if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-        win->_firstch[n] = startpos;
-
-    if (endpos > win->_lastch[n])
-        win->_lastch[n] = endpos;
+    PDC_touch_span(win, win->_cury, startpos, endpos);
 
     PDC_sync(win);
 
@@ -274,12 +274,7 @@ int wvline(WINDOW *win, chtype ch, int n)
     for (n = win->_cury; n < endpos; n++)
     {
         win->_y[n][x] = ch;
-
-        if (x < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-            win->_firstch[n] = x;
-
-        if (x > win->_lastch[n])
-            win->_lastch[n] = x;
+        PDC_touch_span(win, n, x, x);
     }
 
     PDC_sync(win);
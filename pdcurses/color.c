@@ -13,6 +13,8 @@ color
     int start_color(void);
     int init_pair(short pair, short fg, short bg);
     int pair_content(short pair, short *fg, short *bg);
+    int init_extended_pair(int pair, int fg, int bg);
+    int extended_pair_content(int pair, int *fg, int *bg);
     bool can_change_color(void);
     int init_color(short color, short red, short green, short blue);
     int color_content(short color, short *red, short *green, short *blue);
@@ -20,6 +22,10 @@ color
     int assume_default_colors(int f, int b);
     int use_default_colors(void);
 
+    int alloc_pair(int fg, int bg);
+    int find_pair(int fg, int bg);
+    int free_pair(int pair);
+
     int PDC_set_line_color(short color);
 
 ### Description
@@ -42,18 +48,24 @@ color
    values of the foreground and background colors. The pair number must
    be between 0 and COLOR_PAIRS - 1, inclusive. The foreground and
    background must be between 0 and COLORS - 1, inclusive. If the color
-   pair was previously initialized, the screen is refreshed, and all
-   occurrences of that color-pair are changed to the new definition.
+   pair was previously initialized, all occurrences of that color-pair
+   are changed to the new definition at the next refresh; only the cells
+   that use it are redrawn.
 
    pair_content() is used to determine what the colors of a given color-
    pair consist of.
 
+   init_extended_pair() and extended_pair_content() are the same as
+   init_pair() and pair_content(), but take ints, so that they can reach
+   every pair when PDCurses is built with CHTYPE_64 (65536 pairs).
+
    can_change_color() indicates if the terminal has the capability to
    change the definition of its colors.
 
    init_color() is used to redefine a color, if possible. Each of the
    components -- red, green, and blue -- is specified in a range from 0
-   to 1000, inclusive.
+   to 1000, inclusive. The cells showing that color are redrawn at the
+   next refresh, or the next napms().
 
    color_content() reports the current definition of a color in the same
    format as used by init_color().
@@ -68,6 +80,15 @@ color
    variable PDC_ORIGINAL_COLORS is set at the time start_color() is
    called, that's equivalent to calling use_default_colors().
 
+   alloc_pair(), find_pair() and free_pair() emulate the ncurses
+   extensions of the same names, which manage pairs on the application's
+   behalf. find_pair() returns a pair with the given colors, or -1 if
+   none has been set up. alloc_pair() returns the same, if there is one;
+   otherwise it sets up an unused pair, and when none is left, it
+   recycles the least recently used of the pairs it created before. (A
+   pair set with init_pair() is never recycled.) free_pair() marks a
+   pair as unused again. Both lookups take constant time.
+
    PDC_set_line_color() is used to set the color, globally, for the
    color of the lines drawn for the attributes: A_UNDERLINE, A_LEFT and
    A_RIGHT. A value of -1 (the default) indicates that the current
@@ -78,7 +99,8 @@ color
 ### Return Value
 
    All functions return OK on success and ERR on error, except for
-   has_colors() and can_change_colors(), which return TRUE or FALSE.
+   has_colors() and can_change_colors(), which return TRUE or FALSE,
+   and alloc_pair() and find_pair(), which return a pair number, or -1.
 
 ### Portability
                              X/Open  ncurses  NetBSD
@@ -86,11 +108,16 @@ color
     start_color                 Y       Y       Y
     init_pair                   Y       Y       Y
     pair_content                Y       Y       Y
+    init_extended_pair          -       Y       -
+    extended_pair_content       -       Y       -
     can_change_color            Y       Y       Y
     init_color                  Y       Y       Y
     color_content               Y       Y       Y
     assume_default_colors       -       Y       Y
     use_default_colors          -       Y       Y
+    alloc_pair                  -       Y       -
+    find_pair                   -       Y       -
+    free_pair                   -       Y       -
     PDC_set_line_color          -       -       -
 
 **man-end****************************************************************/
@@ -101,9 +128,6 @@ color
 int COLORS = 0;
 int COLOR_PAIRS = PDC_COLOR_PAIRS;
 
-static bool default_colors = FALSE;
-static short first_col = 0;
-
 int start_color(void)
 {
     PDC_LOG(("start_color() - called\n"));
@@ -113,10 +137,21 @@ int start_color(void)
 
     SP->color_started = TRUE;
 
-    PDC_set_blink(FALSE);   /* Also sets COLORS */
+    /* a headless screen takes whatever number of colors the display
+       has, or else as many as it can keep */
 
-    if (!default_colors && SP->orig_attr && getenv("PDC_ORIGINAL_COLORS"))
-        default_colors = TRUE;
+    if (SP->opaque->headless)
+    {
+        SP->termattrs &= ~A_BLINK;
+        if (!COLORS)
+            COLORS = PDC_MAXCOL;
+    }
+    else
+        PDC_set_blink(FALSE);   /* Also sets COLORS */
+
+    if (!SP->opaque->default_colors && SP->orig_attr &&
+        getenv("PDC_ORIGINAL_COLORS"))
+        SP->opaque->default_colors = TRUE;
 
     PDC_init_atrtab();
 
@@ -132,33 +167,170 @@ static void _normalize(short *fg, short *bg)
         *bg = SP->orig_attr ? SP->orig_back : COLOR_BLACK;
 }
 
-static void _init_pair_core(short pair, short fg, short bg)
+/* Flag a pair whose colors have changed, so that the next update
+   redraws the cells on screen that use it */
+
+static void _mark_stale(int pair)
+{
+    SP->opaque->pair_stale[pair / PDC_BLINK_BITS] |=
+        1UL << (pair % PDC_BLINK_BITS);
+    SP->opaque->stale_pairs = TRUE;
+}
+
+/* The index behind find_pair() and alloc_pair(): hash chains of the set
+   pairs, keyed on their colors, and a list of the pairs alloc_pair()
+   handed out, from least to most recently used. It's built on first
+   use, and kept up to date from then on. */
+
+#define _HASH(fg, bg) \
+    ((unsigned)(((fg) + 1) * 1031 + (bg) + 1) % PDC_COLOR_PAIRS)
+
+static void _hash_add(int pair)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    PDC_PAIR *p = SP->atrtab + pair;
+    unsigned h = _HASH(p->f, p->b);
+
+    o->pair_link[pair].next = o->pair_hash[h];
+    o->pair_hash[h] = pair;
+}
+
+static void _hash_remove(int pair)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    PDC_PAIR *p = SP->atrtab + pair;
+    int *link = o->pair_hash + _HASH(p->f, p->b);
+
+    while (*link != -1 && *link != pair)
+        link = &(o->pair_link[*link].next);
+
+    if (*link == pair)
+        *link = o->pair_link[pair].next;
+}
+
+static void _lru_remove(int pair)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    PDC_PAIRLINK *l = o->pair_link + pair;
+
+    if (!l->listed)
+        return;
+
+    if (l->older == -1)
+        o->pair_oldest = l->newer;
+    else
+        o->pair_link[l->older].newer = l->newer;
+
+    if (l->newer == -1)
+        o->pair_newest = l->older;
+    else
+        o->pair_link[l->newer].older = l->older;
+
+    l->listed = FALSE;
+}
+
+static void _lru_add(int pair)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    PDC_PAIRLINK *l = o->pair_link + pair;
+
+    l->older = o->pair_newest;
+    l->newer = -1;
+    l->listed = TRUE;
+
+    if (o->pair_newest == -1)
+        o->pair_oldest = pair;
+    else
+        o->pair_link[o->pair_newest].newer = pair;
+
+    o->pair_newest = pair;
+}
+
+static bool _build_index(void)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    int i;
+
+    if (o->pair_hash)
+        return TRUE;
+
+    o->pair_hash = malloc(PDC_COLOR_PAIRS * sizeof(int));
+    o->pair_link = malloc(PDC_COLOR_PAIRS * sizeof(PDC_PAIRLINK));
+
+    if (!o->pair_hash || !o->pair_link)
+    {
+        free(o->pair_hash);
+        free(o->pair_link);
+        o->pair_hash = NULL;
+        o->pair_link = NULL;
+        return FALSE;
+    }
+
+    o->pair_oldest = o->pair_newest = -1;
+
+    for (i = 0; i < PDC_COLOR_PAIRS; i++)
+    {
+        o->pair_hash[i] = -1;
+        o->pair_link[i].listed = FALSE;
+    }
+
+    for (i = 1; i < COLOR_PAIRS; i++)
+        if (PDC_PAIR_TEST(o->pair_set, i))
+            _hash_add(i);
+
+    return TRUE;
+}
+
+static void _drop_index(void)
 {
+    struct _opaque_screen_t *o = SP->opaque;
+
+    free(o->pair_hash);
+    free(o->pair_link);
+    o->pair_hash = NULL;
+    o->pair_link = NULL;
+}
+
+static void _init_pair_core(int pair, short fg, short bg)
+{
+    struct _opaque_screen_t *o = SP->opaque;
     PDC_PAIR *p = SP->atrtab + pair;
+    bool indexed = o->pair_hash && pair;
 
     _normalize(&fg, &bg);
 
-    /* To allow the PDC_PRESERVE_SCREEN option to work, we only reset
-       curscr if this call to init_pair() alters a color pair created by
-       the user. */
+    /* To allow the PDC_PRESERVE_SCREEN option to work, we only redraw
+       if this call to init_pair() alters a color pair created by the
+       user. */
 
-    if (p->set)
+    if (PDC_PAIR_TEST(o->pair_set, pair))
     {
         if (p->f != fg || p->b != bg)
-            curscr->_clear = TRUE;
+            _mark_stale(pair);
+
+        if (indexed)
+        {
+            _hash_remove(pair);
+            _lru_remove(pair);
+        }
     }
 
     p->f = fg;
     p->b = bg;
-    p->set = TRUE;
+    o->pair_set[pair / PDC_BLINK_BITS] |= 1UL << (pair % PDC_BLINK_BITS);
+
+    if (indexed)
+        _hash_add(pair);
 }
 
-int init_pair(short pair, short fg, short bg)
+int init_extended_pair(int pair, int fg, int bg)
 {
-    PDC_LOG(("init_pair() - called: pair %d fg %d bg %d\n", pair, fg, bg));
+    PDC_LOG(("init_extended_pair() - called: pair %d fg %d bg %d\n",
+             pair, fg, bg));
 
     if (!SP || !SP->color_started || pair < 1 || pair >= COLOR_PAIRS ||
-        fg < first_col || fg >= COLORS || bg < first_col || bg >= COLORS)
+        fg < SP->opaque->first_col || fg >= COLORS ||
+        bg < SP->opaque->first_col || bg >= COLORS)
         return ERR;
 
     _init_pair_core(pair, fg, bg);
@@ -166,6 +338,13 @@ int init_pair(short pair, short fg, short bg)
     return OK;
 }
 
+int init_pair(short pair, short fg, short bg)
+{
+    PDC_LOG(("init_pair() - called: pair %d fg %d bg %d\n", pair, fg, bg));
+
+    return init_extended_pair(pair, fg, bg);
+}
+
 bool has_colors(void)
 {
     PDC_LOG(("has_colors() - called\n"));
@@ -173,17 +352,92 @@ bool has_colors(void)
     return SP ? !(SP->mono) : FALSE;
 }
 
+/* Simulated values for platforms that don't support palette changing */
+
+static void _fixed_color(short color, short *red, short *green,
+                         short *blue)
+{
+    short maxval = (color & 8) ? 1000 : 680;
+
+    *red = (color & COLOR_RED) ? maxval : 0;
+    *green = (color & COLOR_GREEN) ? maxval : 0;
+    *blue = (color & COLOR_BLUE) ? maxval : 0;
+}
+
+/* A headless screen's palette, made on first use from the display's */
+
+static short *_palette(void)
+{
+    short *pal = SP->opaque->palette;
+    int i;
+
+    if (pal)
+        return pal;
+
+    pal = malloc(PDC_MAXCOL * 3 * sizeof(short));
+    if (!pal)
+        return NULL;
+
+    for (i = 0; i < PDC_MAXCOL; i++)
+    {
+        short *rgb = pal + i * 3;
+
+        if (i >= COLORS || !PDC_can_change_color() ||
+            PDC_color_content(i, rgb, rgb + 1, rgb + 2) == ERR)
+            _fixed_color(i, rgb, rgb + 1, rgb + 2);
+    }
+
+    SP->opaque->palette = pal;
+
+    return pal;
+}
+
 int init_color(short color, short red, short green, short blue)
 {
+    bool headless;
+    int i;
+
     PDC_LOG(("init_color() - called\n"));
 
-    if (!SP || color < 0 || color >= COLORS || !PDC_can_change_color() ||
+    headless = SP && SP->opaque->headless;
+
+    if (!SP || color < 0 || color >= COLORS ||
+        !(headless || PDC_can_change_color()) ||
         red < -1 || red > 1000 || green < -1 || green > 1000 ||
         blue < -1 || blue > 1000)
         return ERR;
 
+    /* every pair that shows this color, including as the bright
+       version of its own, or as the default color for -1, will need
+       redrawing */
+
+    for (i = 0; i < PDC_COLOR_PAIRS; i++)
+    {
+        short f = SP->atrtab[i].f, b = SP->atrtab[i].b;
+
+        _normalize(&f, &b);
+
+        if (f == color || b == color || (f | 8) == color || (b | 8) == color)
+            _mark_stale(i);
+    }
+
     SP->dirty = TRUE;
 
+    if (headless)
+    {
+        short *rgb = _palette();
+
+        if (!rgb || color >= PDC_MAXCOL)
+            return ERR;
+
+        rgb += color * 3;
+        rgb[0] = red;
+        rgb[1] = green;
+        rgb[2] = blue;
+
+        return OK;
+    }
+
     return PDC_init_color(color, red, green, blue);
 }
 
@@ -194,35 +448,38 @@ int color_content(short color, short *red, short *green, short *blue)
     if (color < 0 || color >= COLORS || !red || !green || !blue)
         return ERR;
 
-    if (PDC_can_change_color())
-        return PDC_color_content(color, red, green, blue);
-    else
+    if (SP && SP->opaque->headless)
     {
-        /* Simulated values for platforms that don't support palette
-           changing */
+        short *rgb = _palette();
 
-        short maxval = (color & 8) ? 1000 : 680;
+        if (!rgb || color >= PDC_MAXCOL)
+            return ERR;
 
-        *red = (color & COLOR_RED) ? maxval : 0;
-        *green = (color & COLOR_GREEN) ? maxval : 0;
-        *blue = (color & COLOR_BLUE) ? maxval : 0;
-
-        return OK;
+        rgb += color * 3;
+        *red = rgb[0];
+        *green = rgb[1];
+        *blue = rgb[2];
     }
+    else if (PDC_can_change_color())
+        return PDC_color_content(color, red, green, blue);
+    else
+        _fixed_color(color, red, green, blue);
+
+    return OK;
 }
 
 bool can_change_color(void)
 {
     PDC_LOG(("can_change_color() - called\n"));
 
-    return PDC_can_change_color();
+    return (SP && SP->opaque->headless) ? TRUE : PDC_can_change_color();
 }
 
-int pair_content(short pair, short *fg, short *bg)
+int extended_pair_content(int pair, int *fg, int *bg)
 {
-    PDC_LOG(("pair_content() - called\n"));
+    PDC_LOG(("extended_pair_content() - called\n"));
 
-    if (pair < 0 || pair >= COLOR_PAIRS || !fg || !bg)
+    if (!SP || pair < 0 || pair >= COLOR_PAIRS || !fg || !bg)
         return ERR;
 
     *fg = SP->atrtab[pair].f;
@@ -231,11 +488,144 @@ int pair_content(short pair, short *fg, short *bg)
     return OK;
 }
 
+int pair_content(short pair, short *fg, short *bg)
+{
+    int f, b;
+
+    PDC_LOG(("pair_content() - called\n"));
+
+    if (!fg || !bg || extended_pair_content(pair, &f, &b) == ERR)
+        return ERR;
+
+    *fg = f;
+    *bg = b;
+
+    return OK;
+}
+
+int find_pair(int fg, int bg)
+{
+    struct _opaque_screen_t *o;
+    short f = fg, b = bg;
+    int pair;
+
+    PDC_LOG(("find_pair() - called: fg %d bg %d\n", fg, bg));
+
+    if (!SP || !SP->color_started || !_build_index())
+        return -1;
+
+    o = SP->opaque;
+    _normalize(&f, &b);
+
+    for (pair = o->pair_hash[_HASH(f, b)]; pair != -1;
+         pair = o->pair_link[pair].next)
+    {
+        if (SP->atrtab[pair].f == f && SP->atrtab[pair].b == b)
+        {
+            /* a lookup counts as a use */
+
+            if (o->pair_link[pair].listed)
+            {
+                _lru_remove(pair);
+                _lru_add(pair);
+            }
+
+            return pair;
+        }
+    }
+
+    return -1;
+}
+
+/* the lowest unset pair, or -1; whole words of set pairs are skipped */
+
+static int _unused_pair(void)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    int pair = o->pair_free;
+
+    if (pair < 1)
+        pair = 1;
+
+    while (pair < COLOR_PAIRS)
+    {
+        if (!(pair % PDC_BLINK_BITS) &&
+            o->pair_set[pair / PDC_BLINK_BITS] == ~0UL)
+            pair += PDC_BLINK_BITS;
+        else if (PDC_PAIR_TEST(o->pair_set, pair))
+            pair++;
+        else
+        {
+            o->pair_free = pair + 1;
+            return pair;
+        }
+    }
+
+    o->pair_free = COLOR_PAIRS;
+
+    return -1;
+}
+
+int alloc_pair(int fg, int bg)
+{
+    int pair;
+
+    PDC_LOG(("alloc_pair() - called: fg %d bg %d\n", fg, bg));
+
+    if (!SP || !SP->color_started ||
+        fg < SP->opaque->first_col || fg >= COLORS ||
+        bg < SP->opaque->first_col || bg >= COLORS)
+        return -1;
+
+    pair = find_pair(fg, bg);
+    if (pair != -1 || !SP->opaque->pair_hash)
+        return pair;
+
+    pair = _unused_pair();
+    if (pair == -1)
+        pair = SP->opaque->pair_oldest;
+    if (pair == -1)
+        return -1;
+
+    _init_pair_core(pair, fg, bg);
+    _lru_add(pair);
+
+    return pair;
+}
+
+int free_pair(int pair)
+{
+    struct _opaque_screen_t *o;
+
+    PDC_LOG(("free_pair() - called: pair %d\n", pair));
+
+    if (!SP || pair < 1 || pair >= COLOR_PAIRS)
+        return ERR;
+
+    o = SP->opaque;
+
+    if (!PDC_PAIR_TEST(o->pair_set, pair))
+        return ERR;
+
+    if (o->pair_hash)
+    {
+        _hash_remove(pair);
+        _lru_remove(pair);
+    }
+
+    o->pair_set[pair / PDC_BLINK_BITS] &= ~(1UL << (pair % PDC_BLINK_BITS));
+
+    if (pair < o->pair_free)
+        o->pair_free = pair;
+
+    return OK;
+}
+
 int assume_default_colors(int f, int b)
 {
     PDC_LOG(("assume_default_colors() - called: f %d b %d\n", f, b));
 
-    if (f < -1 || f >= COLORS || b < -1 || b >= COLORS)
+    if (!SP || f < -1 || f >= COLORS || b < -1 || b >= COLORS)
         return ERR;
 
     if (SP->color_started)
@@ -248,8 +638,11 @@ int use_default_colors(void)
 {
     PDC_LOG(("use_default_colors() - called\n"));
 
-    default_colors = TRUE;
-    first_col = -1;
+    if (!SP)
+        return ERR;
+
+    SP->opaque->default_colors = TRUE;
+    SP->opaque->first_col = -1;
 
     return assume_default_colors(-1, -1);
 }
@@ -266,12 +659,68 @@ int PDC_set_line_color(short color)
     return OK;
 }
 
+#ifdef A_RGB_COLOR
+
+/* 0xRRGGBB from the low 18 bits of c, as packed by A_RGB() */
+
+unsigned long PDC_rgb24(chtype c)
+{
+    unsigned long r = (c >> 12) & 0x3f, g = (c >> 6) & 0x3f, b = c & 0x3f;
+
+    r = (r << 2) | (r >> 4);
+    g = (g << 2) | (g >> 4);
+    b = (b << 2) | (b >> 4);
+
+    return (r << 16) | (g << 8) | b;
+}
+
+/* The nearest of the 16 basic colors: a channel counts if it's at least
+   half the strongest one, and a strong enough color is bright */
+
+static int _nearest(unsigned long rgb)
+{
+    int r = (rgb >> 16) & 0xff, g = (rgb >> 8) & 0xff, b = rgb & 0xff;
+    int top = max(r, max(g, b));
+    int color = 0;
+
+    if (top < 0x40)
+        return COLOR_BLACK;
+
+    if (r * 2 >= top)
+        color |= COLOR_RED;
+    if (g * 2 >= top)
+        color |= COLOR_GREEN;
+    if (b * 2 >= top)
+        color |= COLOR_BLUE;
+
+    return (top > 0xc0) ? color | 8 : color;
+}
+
+#endif
+
+/* The colors of cell ch, as color numbers, for ports that can't show
+   direct RGB colors. A direct-color cell gets the nearest basic ones. */
+
+void PDC_cell_colors(chtype ch, int *fg, int *bg)
+{
+#ifdef A_RGB_COLOR
+    if (ch & A_RGB_COLOR)
+    {
+        *fg = _nearest(PDC_RGB_FORE(ch));
+        *bg = _nearest(PDC_RGB_BACK(ch));
+        return;
+    }
+#endif
+    extended_pair_content(PAIR_NUMBER(ch), fg, bg);
+}
+
 void PDC_init_atrtab(void)
 {
     PDC_PAIR *p = SP->atrtab;
-    short i, fg, bg;
+    short fg, bg;
+    int i;
 
-    if (SP->color_started && !default_colors)
+    if (SP->color_started && !SP->opaque->default_colors)
     {
         fg = COLOR_WHITE;
         bg = COLOR_BLACK;
@@ -285,6 +734,10 @@ void PDC_init_atrtab(void)
     {
         p[i].f = fg;
         p[i].b = bg;
-        p[i].set = FALSE;
     }
+
+    memset(SP->opaque->pair_set, 0, PDC_PAIR_WORDS * sizeof(unsigned long));
+    SP->opaque->pair_free = 1;
+
+    _drop_index();
 }
@@ -58,10 +58,7 @@ int wdelch(WINDOW *win)
 
     win->_y[y][maxx] = win->_bkgd;
 
-    win->_lastch[y] = maxx;
-
-    if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
-        win->_firstch[y] = x;
+    PDC_touch_span(win, y, x, maxx);
 
     PDC_sync(win);
 
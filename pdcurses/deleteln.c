@@ -55,38 +55,9 @@ deleteln
 
 int wdeleteln(WINDOW *win)
 {
-    chtype blank, *temp, *ptr;
-    int y;
-
     PDC_LOG(("wdeleteln() - called\n"));
 
-    if (!win)
-        return ERR;
-
-    /* wrs (4/10/93) account for window background */
-
-    blank = win->_bkgd;
-
-    temp = win->_y[win->_cury];
-
-    for (y = win->_cury; y < win->_bmarg; y++)
-    {
-        win->_y[y] = win->_y[y + 1];
-        win->_firstch[y] = 0;
-        win->_lastch[y] = win->_maxx - 1;
-    }
-
-    for (ptr = temp; (ptr - temp < win->_maxx); ptr++)
-        *ptr = blank;           /* make a blank line */
-
-    if (win->_cury <= win->_bmarg)
-    {
-        win->_firstch[win->_bmarg] = 0;
-        win->_lastch[win->_bmarg] = win->_maxx - 1;
-        win->_y[win->_bmarg] = temp;
-    }
-
-    return OK;
+    return winsdelln(win, -1);
 }
 
 int deleteln(void)
@@ -118,26 +89,18 @@ int mvwdeleteln(WINDOW *win, int y, int x)
 
 int winsdelln(WINDOW *win, int n)
 {
-    int i;
-
     PDC_LOG(("winsdelln() - called\n"));
 
     if (!win)
         return ERR;
 
+    /* inserted lines push those below off the bottom of the window;
+       deleted ones pull up those down to the scrolling region's end */
+
     if (n > 0)
-    {
-        for (i = 0; i < n; i++)
-            if (winsertln(win) == ERR)
-                return ERR;
-    }
+        PDC_scroll_lines(win, win->_cury, win->_maxy - 1, -n);
     else if (n < 0)
-    {
-        n = -n;
-        for (i = 0; i < n; i++)
-            if (wdeleteln(win) == ERR)
-                return ERR;
-    }
+        PDC_scroll_lines(win, win->_cury, max(win->_cury, win->_bmarg), -n);
 
     return OK;
 }
@@ -151,36 +114,9 @@ int insdelln(int n)
 
 int winsertln(WINDOW *win)
 {
-    chtype blank, *temp, *end;
-    int y;
-
     PDC_LOG(("winsertln() - called\n"));
 
-    if (!win)
-        return ERR;
-
-    /* wrs (4/10/93) account for window background */
-
-    blank = win->_bkgd;
-
-    temp = win->_y[win->_maxy - 1];
-
-    for (y = win->_maxy - 1; y > win->_cury; y--)
-    {
-        win->_y[y] = win->_y[y - 1];
-        win->_firstch[y] = 0;
-        win->_lastch[y] = win->_maxx - 1;
-    }
-
-    win->_y[win->_cury] = temp;
-
-    for (end = &temp[win->_maxx - 1]; temp <= end; temp++)
-        *temp = blank;
-
-    win->_firstch[win->_cury] = 0;
-    win->_lastch[win->_cury] = win->_maxx - 1;
-
-    return OK;
+    return winsdelln(win, 1);
 }
 
 int insertln(void)
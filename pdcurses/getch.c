@@ -117,21 +117,64 @@ static int _get_box(int *y_start, int *y_end, int *x_start, int *x_end)
     return (end - start) + (*y_end - *y_start);
 }
 
-static void _highlight(void)
+/* Mark cells start through end - 1 (as y * COLS + x) changed in
+   curscr */
+
+static void _touch_cells(int start, int end)
 {
-    int i, j, y_start, y_end, x_start, x_end;
+    int y, y_start = start / COLS, y_end = (end - 1) / COLS;
 
-    if (-1 == SP->sel_start)
-        return;
+    for (y = y_start; y <= y_end; y++)
+    {
+        int first = (y == y_start) ? start % COLS : 0;
+        int last = (y == y_end) ? (end - 1) % COLS : COLS - 1;
+
+        PDC_touch_span(curscr, y, first, last);
+    }
+}
 
-    _get_box(&y_start, &y_end, &x_start, &x_end);
+/* Move the selection to run from start to end, or remove it if start
+   is -1. doupdate() draws the highlight, so only the cells whose
+   selection state changes need redrawing. */
 
-    for (j = y_start; j <= y_end; j++)
-        for (i = (j == y_start ? x_start : 0);
-             i < (j == y_end ? x_end : COLS); i++)
-            curscr->_y[j][i] ^= A_REVERSE;
+static void _select(int start, int end)
+{
+    int old_start = SP->sel_start, old_end = SP->sel_end;
+
+    if (old_start > old_end)
+    {
+        old_start = SP->sel_end;
+        old_end = SP->sel_start;
+    }
+
+    SP->sel_start = start;
+    SP->sel_end = end;
+
+    if (start > end)
+    {
+        start = SP->sel_end;
+        end = SP->sel_start;
+    }
 
-    wrefresh(curscr);
+    if (-1 == old_start || old_start == old_end)
+    {
+        if (-1 == start || start == end)
+            return;
+
+        _touch_cells(start, end);
+    }
+    else if (-1 == start || start == end)
+        _touch_cells(old_start, old_end);
+    else
+    {
+        if (start != old_start)
+            _touch_cells(min(start, old_start), max(start, old_start));
+
+        if (end != old_end)
+            _touch_cells(min(end, old_end), max(end, old_end));
+    }
+
+    doupdate();
 }
 
 static void _copy(void)
@@ -187,6 +230,28 @@ static void _copy(void)
 #endif
 }
 
+int (*PDC_clip_request)(void) = NULL;
+int (*PDC_clip_poll)(char **, long *) = NULL;
+
+/* Fetching the clipboard in the background, for ports that set the
+   hooks above; for the rest, it's always there at once, so a request
+   does nothing, and polling just gets it */
+
+int PDC_requestclipboard(void)
+{
+    PDC_LOG(("PDC_requestclipboard() - called\n"));
+
+    return PDC_clip_request ? PDC_clip_request() : PDC_CLIP_SUCCESS;
+}
+
+int PDC_pollclipboard(char **contents, long *length)
+{
+    PDC_LOG(("PDC_pollclipboard() - called\n"));
+
+    return PDC_clip_poll ? PDC_clip_poll(contents, length) :
+                           PDC_getclipboard(contents, length);
+}
+
 static int _paste(void)
 {
 #ifdef PDC_WIDE
@@ -199,7 +264,21 @@ static int _paste(void)
     long len, newmax;
     int key;
 
-    key = PDC_getclipboard(&paste, &len);
+    /* large selections can take a while to arrive; rather than wait,
+       keep polling from wgetch() */
+
+    if (!SP->paste_pending)
+    {
+        if (PDC_CLIP_SUCCESS != PDC_requestclipboard())
+            return -1;
+        SP->paste_pending = TRUE;
+    }
+
+    key = PDC_pollclipboard(&paste, &len);
+    if (PDC_CLIP_PENDING == key)
+        return -1;
+
+    SP->paste_pending = FALSE;
     if (PDC_CLIP_SUCCESS != key || !len)
         return -1;
 
@@ -240,15 +319,15 @@ static int _mouse_key(void)
         switch (SP->mouse_status.button[0] & BUTTON_ACTION_MASK)
         {
         case BUTTON_PRESSED:
-            _highlight();
-            SP->sel_start = SP->sel_end = i;
+            _select(i, i);
             return -1;
         case BUTTON_MOVED:
-            _highlight();
-            SP->sel_end = i;
-            _highlight();
+            _select(SP->sel_start, i);
             return -1;
         case BUTTON_RELEASED:
+        case BUTTON_CLICKED:
+        case BUTTON_DOUBLE_CLICKED:
+        case BUTTON_TRIPLE_CLICKED:
             _copy();
             return -1;
         }
@@ -279,6 +358,9 @@ static int _mouse_key(void)
                 || (!(mbe & (BUTTON1_DOUBLE_CLICKED << shf)) &&
                     (button == BUTTON_DOUBLE_CLICKED))
 
+                || (!(mbe & (BUTTON1_TRIPLE_CLICKED << shf)) &&
+                    (button == BUTTON_TRIPLE_CLICKED))
+
                 || (!(mbe & (BUTTON1_MOVED << shf)) &&
                     (button == BUTTON_MOVED))
 
@@ -320,15 +402,10 @@ static int _mouse_key(void)
     return key;
 }
 
-int wgetch(WINDOW *win)
+static int _getch(WINDOW *win)
 {
     int key, waitcount;
 
-    PDC_LOG(("wgetch() - called\n"));
-
-    if (!win || !SP)
-        return ERR;
-
     waitcount = 0;
 
     /* set the number of 1/20th second napms() calls */
@@ -354,11 +431,20 @@ int wgetch(WINDOW *win)
           win->_begy + win->_cury != SP->cursrow)) || is_wintouched(win)))
         wrefresh(win);
 
+    /* send out an update that was held back by PDC_set_frame_rate() */
+
+    PDC_frame_due();
+
     /* if ungotten char exists, remove and return it */
 
     if (SP->c_ungind)
         return SP->c_ungch[--(SP->c_ungind)];
 
+    /* a headless screen has nothing else to read */
+
+    if (SP->opaque->headless)
+        return ERR;
+
     /* if normal and data in buffer */
 
     if ((!SP->raw_inp && !SP->cbreak) && (SP->c_gindex < SP->c_pindex))
@@ -377,6 +463,18 @@ int wgetch(WINDOW *win)
 
         if (!PDC_check_key())
         {
+            /* has a pending paste come in? */
+
+            if (SP->paste_pending)
+            {
+                key = _paste();
+                if (key != -1)
+                {
+                    SP->key_code = FALSE;
+                    return key;
+                }
+            }
+
             /* if not, handle timeout() and halfdelay() */
 
             if (SP->delaytenths || win->_delayms)
@@ -427,8 +525,7 @@ int wgetch(WINDOW *win)
         if (key == -1)
             continue;
 
-        _highlight();
-        SP->sel_start = SP->sel_end = -1;
+        _select(-1, -1);
 
         /* translate CR */
 
@@ -466,6 +563,23 @@ int wgetch(WINDOW *win)
     }
 }
 
+int wgetch(WINDOW *win)
+{
+    int key;
+
+    PDC_LOG(("wgetch() - called\n"));
+
+    if (!win || !SP)
+        return ERR;
+
+    key = _getch(win);
+
+    if (key != ERR && SP->opaque->record)
+        PDC_record_key(key);
+
+    return key;
+}
+
 int mvgetch(int y, int x)
 {
     PDC_LOG(("mvgetch() - called\n"));
@@ -505,7 +619,8 @@ int flushinp(void)
     if (!SP)
         return ERR;
 
-    PDC_flushinp();
+    if (!SP->opaque->headless)
+        PDC_flushinp();
 
     SP->c_gindex = 1;       /* set indices to kill buffer */
     SP->c_pindex = 0;
@@ -532,7 +647,7 @@ int PDC_return_key_modifiers(bool flag)
         return ERR;
 
     SP->return_key_modifiers = flag;
-    return PDC_modifiers_set();
+    return SP->opaque->headless ? OK : PDC_modifiers_set();
 }
 
 #ifdef PDC_WIDE
@@ -40,17 +40,38 @@ initscr
    isendwin() returns TRUE if endwin() has been called without a
    subsequent refresh, unless SP is NULL.
 
-   In some implementations of curses, newterm() allows the use of
-   multiple terminals. Here, it's just an alternative interface for
-   initscr(). It always returns SP, or NULL.
+   newterm() creates an additional, independent screen, and makes it
+   the current one. All screens share the one display that PDCurses
+   opens (the terminal window, console, or X11 or SDL window); only the
+   current screen is drawn there. Each has its own curscr, stdscr,
+   windows, color pairs, input modes and soft labels, but the display's
+   own settings -- its palette, mouse mask, cursor shape, title and the
+   like -- are shared, and whichever screen is current changes them for
+   all. The outfd and infd parameters are ignored. If there is no
+   screen yet, newterm() is equivalent to initscr(). It returns the new
+   screen, or NULL.
+
+   With a type of "headless", the new screen is never drawn on the
+   display, and leaves it alone entirely: refreshing it updates only its
+   curscr, and whatever mirrors or records it (see PDC_mirror_screen()
+   and PDC_record()); it has its own palette, for init_color(); it
+   reads no keys or mouse events, so wgetch() returns ERR unless a key
+   was pushed back with ungetch(); and resize_term() sets its size
+   freely. It starts at the size of the display. The display must
+   already be open. The port-specific functions, such as
+   PDC_set_title() and PDC_set_blink(), still act on the display.
+
+   set_term() makes the given screen current, and returns the previous
+   one. LINES, COLS, TABSIZE, curscr and stdscr switch with it. The
+   next refresh repaints the whole display. If the display was resized
+   while another screen was current, set_term() flags a resize as if
+   the user had done it, and KEY_RESIZE is the next key returned.
 
    delscreen() frees the memory allocated by newterm() or initscr(),
-   since it's not freed by endwin(). This function is usually not
-   needed. In PDCurses, the parameter must be the value of SP, and
-   delscreen() sets SP to NULL.
-
-   set_term() does nothing meaningful in PDCurses, but is included for
-   compatibility with other curses implementations.
+   since it's not freed by endwin(). Any screen may be deleted; if it's
+   the current one, SP is set to NULL, and set_term() must be called
+   before using another screen. Deleting the last screen closes the
+   display.
 
    resize_term() is effectively two functions: When called with nonzero
    values for nlines and ncols, it attempts to resize the screen to the
@@ -98,6 +119,7 @@ initscr
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 
 char ttytype[128];
 
@@ -116,24 +138,48 @@ MOUSE_STATUS Mouse_status;
 extern RIPPEDOFFLINE linesripped[5];
 extern char linesrippedoff;
 
-WINDOW *initscr(void)
+static int screens = 0;               /* SCREENs sharing the display */
+
+/* park the globals of the current screen in its private state */
+
+static void _stash_screen(void)
 {
-    int i;
+    if (SP)
+    {
+        SP->opaque->curscr = curscr;
+        SP->opaque->stdscr = stdscr;
+        SP->opaque->tabsize = TABSIZE;
+        SP->opaque->mouse_status = Mouse_status;
+    }
+}
 
-    PDC_LOG(("initscr() - called\n"));
+/* ...and bring them back when it becomes current again */
 
-    if (SP && SP->alive)
-        return NULL;
+static void _unstash_screen(void)
+{
+    curscr = SP->opaque->curscr;
+    stdscr = SP->opaque->stdscr;
+    TABSIZE = SP->opaque->tabsize;
+    Mouse_status = SP->opaque->mouse_status;
 
-    SP = calloc(1, sizeof(SCREEN));
-    if (!SP)
+    LINES = SP->lines - SP->linesrippedoff - SP->slklines;
+    COLS = SP->cols;
+}
+
+/* set up the new SP, for a display that's already open */
+
+static WINDOW *_init_screen(bool headless)
+{
+    int i;
+
+    SP->opaque = calloc(1, sizeof(struct _opaque_screen_t));
+    if (!SP->opaque)
         return NULL;
 
-    if (PDC_scr_open() == ERR)
-    {
-        fprintf(stderr, "initscr(): Unable to create SP\n");
-        exit(8);
-    }
+    SP->opaque->headless = headless;
+    screens++;
+
+    TABSIZE = 8;
 
     SP->autocr = TRUE;       /* cr -> lf by default */
     SP->raw_out = FALSE;     /* tty I/O modes */
@@ -185,6 +231,8 @@ WINDOW *initscr(void)
     wattrset(SP->lastscr, (chtype)(-1));
     werase(SP->lastscr);
 
+    PDC_blink_alloc();
+
     PDC_slk_initialize();
     LINES -= SP->slklines;
 
@@ -227,7 +275,9 @@ WINDOW *initscr(void)
         curscr->_clear = TRUE;
 
     SP->atrtab = calloc(PDC_COLOR_PAIRS, sizeof(PDC_PAIR));
-    if (!SP->atrtab)
+    SP->opaque->pair_set = calloc(PDC_PAIR_WORDS, sizeof(unsigned long));
+    SP->opaque->pair_stale = calloc(PDC_PAIR_WORDS, sizeof(unsigned long));
+    if (!SP->atrtab || !SP->opaque->pair_set || !SP->opaque->pair_stale)
         return NULL;
     PDC_init_atrtab();  /* set up default colors */
 
@@ -239,8 +289,6 @@ WINDOW *initscr(void)
 
     SP->alive = TRUE;
 
-    def_shell_mode();
-
     sprintf(ttytype, "pdcurses|PDCurses for %s", PDC_sysname());
 
     SP->c_buffer = malloc(_INBUFSIZ * sizeof(int));
@@ -258,6 +306,31 @@ WINDOW *initscr(void)
     return stdscr;
 }
 
+WINDOW *initscr(void)
+{
+    PDC_LOG(("initscr() - called\n"));
+
+    if (SP && SP->alive)
+        return NULL;
+
+    SP = calloc(1, sizeof(SCREEN));
+    if (!SP)
+        return NULL;
+
+    if (PDC_scr_open() == ERR)
+    {
+        fprintf(stderr, "initscr(): Unable to create SP\n");
+        exit(8);
+    }
+
+    if (!_init_screen(FALSE))
+        return NULL;
+
+    def_shell_mode();
+
+    return stdscr;
+}
+
 #ifdef XCURSES
 WINDOW *Xinitscr(int argc, char **argv)
 {
@@ -274,8 +347,13 @@ int endwin(void)
 
     /* Allow temporary exit from curses using endwin() */
 
+    if (SP->opaque->frame_deferred)
+        PDC_flush_frame();
+
     def_prog_mode();
-    PDC_scr_close();
+
+    if (!SP->opaque->headless)
+        PDC_scr_close();
 
     SP->alive = FALSE;
 
@@ -291,30 +369,120 @@ bool isendwin(void)
 
 SCREEN *newterm(const char *type, FILE *outfd, FILE *infd)
 {
+    SCREEN *old = SP;
+    bool headless = type && !strcmp(type, "headless");
+
     PDC_LOG(("newterm() - called\n"));
 
-    return initscr() ? SP : NULL;
+    if (!old || !old->opaque)
+        return (!headless && initscr()) ? SP : NULL;
+
+    /* The display is already open; the new screen shares it, and takes
+       over what PDC_scr_open() found out about it */
+
+    _stash_screen();
+
+    SP = calloc(1, sizeof(SCREEN));
+    if (!SP)
+    {
+        SP = old;
+        return NULL;
+    }
+
+    SP->mono = old->mono;
+    SP->audible = old->audible;
+    SP->orig_attr = old->orig_attr;
+    SP->orig_fore = old->orig_fore;
+    SP->orig_back = old->orig_back;
+    SP->mouse_wait = old->mouse_wait;
+    SP->termattrs = old->termattrs;
+    SP->_restore = old->_restore;
+
+    if (!_init_screen(headless))
+    {
+        if (SP->opaque)
+            delscreen(SP);
+        else
+            free(SP);
+
+        SP = old;
+        _unstash_screen();
+        return NULL;
+    }
+
+    /* the shell's modes are whatever they were before the first screen
+       took over; saving them now would only catch the program's */
+
+    SP->opaque->ctty[PDC_SH_TTY] = old->opaque->ctty[PDC_SH_TTY];
+
+    return SP;
 }
 
 SCREEN *set_term(SCREEN *new)
 {
+    SCREEN *old = SP;
+
     PDC_LOG(("set_term() - called\n"));
 
-    /* We only support one screen */
+    if (!new || !new->opaque)
+        return NULL;
+
+    if (new == SP)
+        return SP;
+
+    _stash_screen();
+
+    SP = new;
+    _unstash_screen();
+
+    /* The display still shows the old screen. If it was resized in the
+       meantime, tell the application, as for a user resize. */
 
-    return (new == SP) ? SP : NULL;
+    if (SP->alive && !SP->opaque->headless)
+    {
+        curscr->_clear = TRUE;
+        PDC_curs_set(SP->visibility);
+
+        if (SP->lines != PDC_get_rows() || SP->cols != PDC_get_columns())
+        {
+            SP->resized = TRUE;
+            ungetch(KEY_RESIZE);
+        }
+    }
+
+    return old;
 }
 
 void delscreen(SCREEN *sp)
 {
+    SCREEN *cur = SP;
+
     PDC_LOG(("delscreen() - called\n"));
 
-    if (!SP || sp != SP)
+    if (!sp || !sp->opaque)
         return;
 
+    /* work on sp as if it were current, without disturbing the
+       display */
+
+    if (sp != cur)
+    {
+        _stash_screen();
+        SP = sp;
+        _unstash_screen();
+    }
+
+    PDC_mirror_screen(NULL);
+    PDC_record(NULL);
+
     free(SP->c_ungch);
     free(SP->c_buffer);
     free(SP->atrtab);
+    free(SP->opaque->pair_set);
+    free(SP->opaque->pair_stale);
+    free(SP->opaque->pair_hash);
+    free(SP->opaque->pair_link);
+    free(SP->opaque->blinkmap);
 
     PDC_slk_free();     /* free the soft label keys, if needed */
 
@@ -327,24 +495,58 @@ void delscreen(SCREEN *sp)
 
     SP->alive = FALSE;
 
-    PDC_scr_free();
+    /* the last one out closes the display */
+
+    if (!--screens)
+        PDC_scr_free();
 
+    free(SP->opaque->spans);
+    free(SP->opaque->palette);
+    free(SP->opaque);
     free(SP);
-    SP = (SCREEN *)NULL;
+
+    if (sp != cur)
+    {
+        SP = cur;
+        _unstash_screen();
+    }
+    else
+        SP = (SCREEN *)NULL;
 }
 
 int resize_term(int nlines, int ncols)
 {
     PDC_LOG(("resize_term() - called: nlines %d\n", nlines));
 
-    if (!stdscr || PDC_resize_screen(nlines, ncols) == ERR)
+    if (!stdscr)
         return ERR;
 
+    /* a headless screen has no display to ask; (0, 0) keeps its size */
+
+    if (SP->opaque->headless)
+    {
+        if (nlines || ncols)
+        {
+            if (nlines < 2 || ncols < 2)
+                return ERR;
+
+            SP->lines = nlines;
+            SP->cols = ncols;
+        }
+    }
+    else
+    {
+        if (PDC_resize_screen(nlines, ncols) == ERR)
+            return ERR;
+
+        SP->lines = PDC_get_rows();
+        SP->cols = PDC_get_columns();
+    }
+
     SP->resized = FALSE;
 
-    SP->lines = PDC_get_rows();
     LINES = SP->lines - SP->linesrippedoff - SP->slklines;
-    SP->cols = COLS = PDC_get_columns();
+    COLS = SP->cols;
 
     if (SP->cursrow >= SP->lines)
         SP->cursrow = SP->lines - 1;
@@ -357,6 +559,7 @@ int resize_term(int nlines, int ncols)
         return ERR;
 
     werase(SP->lastscr);
+    PDC_blink_alloc();
     curscr->_clear = TRUE;
 
     if (SP->slk_winptr)
@@ -266,7 +266,8 @@ int raw(void)
     if (!SP)
         return ERR;
 
-    PDC_set_keyboard_binary(TRUE);
+    if (!SP->opaque->headless)
+        PDC_set_keyboard_binary(TRUE);
     SP->raw_inp = TRUE;
 
     return OK;
@@ -279,7 +280,8 @@ int noraw(void)
     if (!SP)
         return ERR;
 
-    PDC_set_keyboard_binary(FALSE);
+    if (!SP->opaque->headless)
+        PDC_set_keyboard_binary(FALSE);
     SP->raw_inp = FALSE;
 
     return OK;
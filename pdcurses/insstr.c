@@ -30,7 +30,9 @@ insstr
 ### Description
 
    The insstr() functions insert a character string into a window at the
-   current cursor position, by repeatedly calling winsch(). When
+   current cursor position, as if by calling winsch() for each
+   character, from the last to the first; but the rest of the line is
+   shifted only once, however long the string. When
    PDCurses is built with wide-character support enabled, the narrow-
    character functions treat the string as a multibyte string in the
    current locale, and convert it first. All characters to the right of
@@ -67,6 +69,124 @@ insstr
 
 #include <string.h>
 
+#ifdef PDC_WIDE
+# define _INSCHAR wchar_t
+#else
+# define _INSCHAR unsigned char
+#endif
+
+/* The cell a character becomes when inserted -- the same attribute and
+   background merge as in winsch() */
+
+static chtype _cell(WINDOW *win, chtype ch)
+{
+    chtype attr = ch & A_ATTRIBUTES;
+
+    ch &= A_CHARTEXT;
+
+    if (!(attr & A_COLOR))
+        attr |= win->_attrs;
+
+    if (!(attr & A_COLOR))
+        attr |= win->_bkgd & A_ATTRIBUTES;
+    else
+        attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
+
+    if (ch == ' ')
+        ch = win->_bkgd & A_CHARTEXT;
+
+    return ch | attr;
+}
+
+/* Lay out the first n characters of str the way winsch() leaves them,
+   when called for each one from the end: control characters become
+   "^X", a tab becomes blanks up to the tab stop after the cursor, and a
+   newline clears the rest of the line, so that nothing after it
+   survives (*nl is then set). At most room cells are produced; they're
+   stored in dest, unless it's NULL. Returns the number of cells. */
+
+static int _layout(WINDOW *win, const _INSCHAR *str, int n,
+                   chtype *dest, int room, bool *nl)
+{
+    int i, k = 0;
+
+    for (i = 0; i < n && k < room; i++)
+    {
+        chtype ch = (chtype)str[i], lead = 0;
+        int count = 1;
+
+        if (!SP->raw_out && (ch < ' ' || ch == 0x7f))
+        {
+            if (ch == '\n')
+            {
+                *nl = TRUE;
+                break;
+            }
+
+            if (ch == '\t')
+            {
+                count = ((win->_curx / TABSIZE) + 1) * TABSIZE -
+                        win->_curx;
+                ch = ' ';
+            }
+            else
+            {
+                lead = '^';
+                ch = (ch == 0x7f) ? '?' : ch + '@';
+            }
+        }
+
+        if (lead)
+        {
+            if (dest)
+                dest[k] = _cell(win, lead);
+
+            if (++k == room)
+                break;
+        }
+
+        for (; count && k < room; count--, k++)
+            if (dest)
+                dest[k] = _cell(win, ch);
+    }
+
+    return k;
+}
+
+/* Count the cells first, so that the tail of the line can be moved (or
+   cleared) once, then write them in place */
+
+static int _insert(WINDOW *win, const _INSCHAR *str, int n)
+{
+    chtype *line;
+    int i, k, room, x = win->_curx, y = win->_cury;
+    bool nl = FALSE;
+
+    if (y >= win->_maxy || x >= win->_maxx || y < 0 || x < 0)
+        return ERR;
+
+    room = win->_maxx - x;
+    k = _layout(win, str, n, NULL, room, &nl);
+
+    if (!k && !nl)
+        return OK;
+
+    line = win->_y[y] + x;
+
+    if (nl)
+        for (i = k; i < room; i++)
+            line[i] = win->_bkgd;
+    else
+        memmove(line + k, line, (room - k) * sizeof(chtype));
+
+    _layout(win, str, n, line, k, &nl);
+
+    PDC_touch_span(win, y, x, win->_maxx - 1);
+    PDC_sync(win);
+
+    return OK;
+}
+
 int winsnstr(WINDOW *win, const char *str, int n)
 {
 #ifdef PDC_WIDE
@@ -102,15 +222,10 @@ int winsnstr(WINDOW *win, const char *str, int n)
         i += retval;
     }
 
-    while (p > wstr)
-        if (winsch(win, *--p) == ERR)
+    return _insert(win, wstr, (int)(p - wstr));
 #else
-    while (n)
-        if (winsch(win, (unsigned char)(str[--n])) == ERR)
+    return _insert(win, (const unsigned char *)str, n);
 #endif
-            return ERR;
-
-    return OK;
 }
 
 int insstr(const char *str)
@@ -193,11 +308,7 @@ int wins_nwstr(WINDOW *win, const wchar_t *wstr, int n)
     if (n < 0 || n > len)
         n = len;
 
-    while (n)
-        if (winsch(win, wstr[--n]) == ERR)
-            return ERR;
-
-    return OK;
+    return _insert(win, wstr, n);
 }
 
 int ins_wstr(const wchar_t *wstr)
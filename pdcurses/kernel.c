@@ -88,49 +88,67 @@ kernel
 
 **man-end****************************************************************/
 
-#include <string.h>
-
 RIPPEDOFFLINE linesripped[5];
 char linesrippedoff = 0;
 
-static struct cttyset
-{
-    bool been_set;
-    SCREEN saved;
-} ctty[3];
-
-enum { PDC_SH_TTY, PDC_PR_TTY, PDC_SAVE_TTY };
-
 static void _save_mode(int i)
 {
-    ctty[i].been_set = TRUE;
-
-    memcpy(&(ctty[i].saved), SP, sizeof(SCREEN));
-
-    PDC_save_screen_mode(i);
+    PDC_TTY *saved = &(SP->opaque->ctty[i]);
+
+    saved->been_set = TRUE;
+
+    saved->autocr = SP->autocr;
+    saved->cbreak = SP->cbreak;
+    saved->echo = SP->echo;
+    saved->raw_inp = SP->raw_inp;
+    saved->raw_out = SP->raw_out;
+    saved->audible = SP->audible;
+    saved->delaytenths = SP->delaytenths;
+    saved->visibility = SP->visibility;
+    saved->lines = SP->lines;
+    saved->cols = SP->cols;
+    saved->cursrow = SP->cursrow;
+    saved->curscol = SP->curscol;
+
+    if (!SP->opaque->headless)
+        PDC_save_screen_mode(i);
 }
 
 static int _restore_mode(int i)
 {
-    if (ctty[i].been_set == TRUE)
-    {
-        memcpy(SP, &(ctty[i].saved), sizeof(SCREEN));
+    PDC_TTY *saved = &(SP->opaque->ctty[i]);
 
-        if (ctty[i].saved.raw_out)
+    if (saved->been_set == TRUE)
+    {
+        SP->autocr = saved->autocr;
+        SP->cbreak = saved->cbreak;
+        SP->echo = saved->echo;
+        SP->raw_inp = saved->raw_inp;
+        SP->raw_out = saved->raw_out;
+        SP->audible = saved->audible;
+        SP->delaytenths = saved->delaytenths;
+        SP->visibility = saved->visibility;
+        SP->cursrow = saved->cursrow;
+        SP->curscol = saved->curscol;
+
+        if (saved->raw_out)
             raw();
 
-        PDC_restore_screen_mode(i);
-
-        if ((LINES != ctty[i].saved.lines) ||
-            (COLS != ctty[i].saved.cols))
-            resize_term(ctty[i].saved.lines, ctty[i].saved.cols);
+        if (!SP->opaque->headless)
+            PDC_restore_screen_mode(i);
 
-        PDC_curs_set(ctty[i].saved.visibility);
+        if ((LINES != saved->lines) ||
+            (COLS != saved->cols))
+            resize_term(saved->lines, saved->cols);
 
-        PDC_gotoyx(ctty[i].saved.cursrow, ctty[i].saved.curscol);
+        if (!SP->opaque->headless)
+        {
+            PDC_curs_set(saved->visibility);
+            PDC_gotoyx(saved->cursrow, saved->curscol);
+        }
     }
 
-    return ctty[i].been_set ? OK : ERR;
+    return saved->been_set ? OK : ERR;
 }
 
 int def_prog_mode(void)
@@ -165,7 +183,9 @@ int reset_prog_mode(void)
         return ERR;
 
     _restore_mode(PDC_PR_TTY);
-    PDC_reset_prog_mode();
+
+    if (!SP->opaque->headless)
+        PDC_reset_prog_mode();
 
     return OK;
 }
@@ -178,7 +198,9 @@ int reset_shell_mode(void)
         return ERR;
 
     _restore_mode(PDC_SH_TTY);
-    PDC_reset_shell_mode();
+
+    if (!SP->opaque->headless)
+        PDC_reset_shell_mode();
 
     return OK;
 }
@@ -214,6 +236,13 @@ int curs_set(int visibility)
     if (!SP || visibility < 0 || visibility > 2)
         return ERR;
 
+    if (SP->opaque->headless)
+    {
+        ret_vis = SP->visibility;
+        SP->visibility = visibility;
+        return ret_vis;
+    }
+
     ret_vis = PDC_curs_set(visibility);
 
     /* If the cursor is changing from invisible to visible, update
@@ -227,6 +256,8 @@ int curs_set(int visibility)
 
 int napms(int ms)
 {
+    int due;
+
     PDC_LOG(("napms() - called: ms=%d\n", ms));
 
     if (!SP)
@@ -241,12 +272,24 @@ int napms(int ms)
 
         leaveok(curscr, TRUE);
 
-        wrefresh(curscr);
+        doupdate();
 
         leaveok(curscr, leave_state);
         curs_set(curs_state);
     }
 
+    /* wake up in time for a deferred update, if one falls due */
+
+    due = PDC_frame_due();
+
+    if (due && due < ms)
+    {
+        PDC_napms(due);
+        ms -= due;
+
+        PDC_frame_due();
+    }
+
     if (ms)
         PDC_napms(ms);
 
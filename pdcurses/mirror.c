@@ -0,0 +1,463 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+mirror
+------
+
+### Synopsis
+
+    int PDC_mirror_screen(const char *name);
+
+    PDC_MIRROR *PDC_mirror_attach(const char *name);
+    unsigned long PDC_mirror_begin(PDC_MIRROR *m);
+    bool PDC_mirror_valid(PDC_MIRROR *m, unsigned long seq);
+    void PDC_mirror_detach(PDC_MIRROR *m);
+
+### Description
+
+   PDC_mirror_screen() publishes what's on the screen in a POSIX shared
+   memory object called name (which should begin with a slash), so that
+   other processes -- monitoring tools, say -- can see it. From then
+   on, each doupdate() that changes the screen copies the lines it
+   changed there, along with the cursor position and a count of the
+   frames published. The object is readable only by the same user.
+   PDC_mirror_screen(NULL) stops publishing, and removes the object;
+   delscreen() does the same.
+
+   The other functions are for the watching process, which doesn't
+   need to call initscr(). PDC_mirror_attach() opens the object called
+   name for reading. To look at the screen, call PDC_mirror_begin(): it
+   sets the lines, cols, cury, curx and frame fields of the PDC_MIRROR,
+   and points its cells field at the screen's lines * cols cells, row
+   by row, in the shared memory itself. Read what you need from there,
+   then pass the value PDC_mirror_begin() returned to
+   PDC_mirror_valid(). If that returns FALSE, an update overlapped your
+   reading, and you should start again:
+
+       do
+       {
+           seq = PDC_mirror_begin(m);
+           ch = m->cells[y * m->cols + x];
+       } while (!PDC_mirror_valid(m, seq));
+
+   The writer never waits for its readers. PDC_mirror_detach() closes
+   the object and frees the PDC_MIRROR. Both sides must be built with
+   the same size of chtype (see CHTYPE_64), or PDC_mirror_attach()
+   fails.
+
+### Return Value
+
+   PDC_mirror_screen() returns OK or ERR. PDC_mirror_attach() returns a
+   pointer to a new PDC_MIRROR, or NULL on failure. On systems without
+   POSIX shared memory, these always fail.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_mirror_screen           -       -       -
+    PDC_mirror_attach           -       -       -
+    PDC_mirror_begin            -       -       -
+    PDC_mirror_valid            -       -       -
+    PDC_mirror_detach           -       -       -
+
+**man-end****************************************************************/
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__DJGPP__)
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __GNUC__
+# define _BARRIER() __sync_synchronize()
+#else
+# define _BARRIER()
+#endif
+
+/* The shared object: this header, followed by the cells. seq is odd
+   while an update is being written; readers take a copy before and
+   after reading, and retry if it was odd or has moved (a seqlock). The
+   object only grows, so a reader's mapping is never cut short. */
+
+struct _mirror_seg
+{
+    char magic[4];              /* "PDCm" */
+    int chsize;                 /* sizeof(chtype) in the writer */
+    volatile unsigned long seq;
+    unsigned long size;         /* bytes in the object */
+    unsigned long frame;
+    int lines, cols;
+    int cury, curx;
+};
+
+#define _SEG_CELLS(seg) ((chtype *)((seg) + 1))
+#define _SEG_BYTES(lines, cols) \
+    (sizeof(struct _mirror_seg) + (unsigned long)(lines) * (cols) * \
+     sizeof(chtype))
+
+/* The writer's side, kept with the screen */
+
+struct _pdc_mirror
+{
+    char *name;
+    int fd;
+    struct _mirror_seg *seg;
+    unsigned long size;         /* bytes mapped */
+    int lines, cols;            /* screen size last published */
+    int *firstch, *lastch;      /* changes not yet published */
+    bool resized;               /* publish every line next time */
+};
+
+/* The reader's side */
+
+struct _mirror_reader
+{
+    PDC_MIRROR m;
+    int fd;
+    struct _mirror_seg *seg;
+    unsigned long size;
+};
+
+static void _mirror_close(void)
+{
+    struct _pdc_mirror *mr = SP->opaque->mirror;
+
+    if (mr->seg)
+        munmap((void *)mr->seg, mr->size);
+
+    close(mr->fd);
+    shm_unlink(mr->name);
+
+    free(mr->name);
+    free(mr->firstch);
+    free(mr->lastch);
+    free(mr);
+
+    SP->opaque->mirror = NULL;
+}
+
+/* Fit the object, the mapping and the change records to the current
+   screen size */
+
+static int _mirror_fit(struct _pdc_mirror *mr)
+{
+    unsigned long need = _SEG_BYTES(SP->lines, SP->cols);
+    int *firstch, *lastch, y;
+
+    if (need > mr->size)
+    {
+        void *seg;
+
+        if (ftruncate(mr->fd, need) == -1)
+            return ERR;
+
+        seg = mmap(NULL, need, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   mr->fd, 0);
+        if (seg == MAP_FAILED)
+            return ERR;
+
+        if (mr->seg)
+            munmap((void *)mr->seg, mr->size);
+
+        mr->seg = seg;
+        mr->size = need;
+    }
+
+    firstch = realloc(mr->firstch, SP->lines * sizeof(int));
+    if (firstch)
+        mr->firstch = firstch;
+
+    lastch = realloc(mr->lastch, SP->lines * sizeof(int));
+    if (lastch)
+        mr->lastch = lastch;
+
+    if (!firstch || !lastch)
+        return ERR;
+
+    for (y = 0; y < SP->lines; y++)
+        mr->firstch[y] = mr->lastch[y] = _NO_CHANGE;
+
+    mr->lines = SP->lines;
+    mr->cols = SP->cols;
+    mr->resized = TRUE;
+
+    return OK;
+}
+
+int PDC_mirror_screen(const char *name)
+{
+    struct _pdc_mirror *mr;
+
+    PDC_LOG(("PDC_mirror_screen() - called: %s\n", name ? name : "NULL"));
+
+    if (!SP)
+        return ERR;
+
+    if (SP->opaque->mirror)
+        _mirror_close();
+
+    if (!name)
+        return OK;
+
+    mr = calloc(1, sizeof(struct _pdc_mirror));
+    if (!mr)
+        return ERR;
+
+    mr->name = malloc(strlen(name) + 1);
+    if (!mr->name)
+    {
+        free(mr);
+        return ERR;
+    }
+
+    strcpy(mr->name, name);
+
+    mr->fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (mr->fd == -1)
+    {
+        free(mr->name);
+        free(mr);
+        return ERR;
+    }
+
+    SP->opaque->mirror = mr;
+
+    if (_mirror_fit(mr) == ERR)
+    {
+        _mirror_close();
+        return ERR;
+    }
+
+    memcpy(mr->seg->magic, "PDCm", 4);
+    mr->seg->chsize = sizeof(chtype);
+
+    /* show what's on the screen already */
+
+    PDC_mirror_publish();
+
+    return OK;
+}
+
+/* Note that doupdate() has changed columns first to last of line y */
+
+void PDC_mirror_mark(int y, int first, int last)
+{
+    struct _pdc_mirror *mr = SP->opaque->mirror;
+
+    if (y >= mr->lines)
+        return;
+
+    if (mr->firstch[y] == _NO_CHANGE || first < mr->firstch[y])
+        mr->firstch[y] = first;
+
+    if (last > mr->lastch[y])
+        mr->lastch[y] = last;
+}
+
+/* Copy what's changed since last time from SP->lastscr, the cells
+   actually shown */
+
+void PDC_mirror_publish(void)
+{
+    struct _pdc_mirror *mr = SP->opaque->mirror;
+    struct _mirror_seg *seg;
+    chtype *cells;
+    int y;
+
+    if ((SP->lines != mr->lines || SP->cols != mr->cols) &&
+        _mirror_fit(mr) == ERR)
+    {
+        _mirror_close();
+        return;
+    }
+
+    seg = mr->seg;
+
+    if (!mr->resized && seg->cury == SP->cursrow && seg->curx == SP->curscol)
+    {
+        for (y = 0; y < mr->lines; y++)
+            if (mr->firstch[y] != _NO_CHANGE)
+                break;
+
+        if (y == mr->lines)
+            return;
+    }
+
+    seg->seq++;
+    _BARRIER();
+
+    cells = _SEG_CELLS(seg);
+
+    if (mr->resized)
+    {
+        seg->size = mr->size;
+        seg->lines = mr->lines;
+        seg->cols = mr->cols;
+    }
+
+    for (y = 0; y < mr->lines; y++)
+    {
+        int first = mr->resized ? 0 : mr->firstch[y];
+        int last = mr->resized ? mr->cols - 1 : mr->lastch[y];
+
+        if (first != _NO_CHANGE)
+            memcpy(cells + y * mr->cols + first, SP->lastscr->_y[y] + first,
+                   (last - first + 1) * sizeof(chtype));
+
+        mr->firstch[y] = mr->lastch[y] = _NO_CHANGE;
+    }
+
+    seg->cury = SP->cursrow;
+    seg->curx = SP->curscol;
+    seg->frame++;
+
+    _BARRIER();
+    seg->seq++;
+
+    mr->resized = FALSE;
+}
+
+PDC_MIRROR *PDC_mirror_attach(const char *name)
+{
+    struct _mirror_reader *r;
+    struct stat st;
+
+    if (!name)
+        return (PDC_MIRROR *)NULL;
+
+    r = calloc(1, sizeof(struct _mirror_reader));
+    if (!r)
+        return (PDC_MIRROR *)NULL;
+
+    r->fd = shm_open(name, O_RDONLY, 0);
+    if (r->fd == -1)
+    {
+        free(r);
+        return (PDC_MIRROR *)NULL;
+    }
+
+    if (fstat(r->fd, &st) == -1 ||
+        (unsigned long)st.st_size < sizeof(struct _mirror_seg) ||
+        (r->seg = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, r->fd,
+                       0)) == MAP_FAILED)
+    {
+        close(r->fd);
+        free(r);
+        return (PDC_MIRROR *)NULL;
+    }
+
+    r->size = st.st_size;
+
+    if (memcmp(r->seg->magic, "PDCm", 4) ||
+        r->seg->chsize != sizeof(chtype))
+    {
+        PDC_mirror_detach(&r->m);
+        return (PDC_MIRROR *)NULL;
+    }
+
+    return &r->m;
+}
+
+unsigned long PDC_mirror_begin(PDC_MIRROR *m)
+{
+    struct _mirror_reader *r = (struct _mirror_reader *)m;
+    unsigned long seq = r->seg->seq;
+
+    _BARRIER();
+
+    /* the screen has grown past what's mapped here */
+
+    if (r->seg->size > r->size)
+    {
+        unsigned long size = r->seg->size;
+        void *seg = mmap(NULL, size, PROT_READ, MAP_SHARED, r->fd, 0);
+
+        if (seg != MAP_FAILED)
+        {
+            munmap((void *)r->seg, r->size);
+            r->seg = seg;
+            r->size = size;
+        }
+    }
+
+    m->lines = r->seg->lines;
+    m->cols = r->seg->cols;
+    m->cury = r->seg->cury;
+    m->curx = r->seg->curx;
+    m->frame = r->seg->frame;
+    m->cells = _SEG_CELLS(r->seg);
+
+    /* never point past the mapping, even mid-update */
+
+    if (_SEG_BYTES(m->lines, m->cols) > r->size || m->lines < 0 ||
+        m->cols < 0)
+        m->lines = m->cols = 0;
+
+    return seq;
+}
+
+bool PDC_mirror_valid(PDC_MIRROR *m, unsigned long seq)
+{
+    struct _mirror_reader *r = (struct _mirror_reader *)m;
+
+    _BARRIER();
+
+    return !(seq & 1) && r->seg->seq == seq;
+}
+
+void PDC_mirror_detach(PDC_MIRROR *m)
+{
+    struct _mirror_reader *r = (struct _mirror_reader *)m;
+
+    if (!r)
+        return;
+
+    munmap((void *)r->seg, r->size);
+    close(r->fd);
+    free(r);
+}
+
+#else
+
+/* no POSIX shared memory */
+
+int PDC_mirror_screen(const char *name)
+{
+    PDC_LOG(("PDC_mirror_screen() - called\n"));
+
+    return name ? ERR : OK;
+}
+
+void PDC_mirror_mark(int y, int first, int last)
+{
+}
+
+void PDC_mirror_publish(void)
+{
+}
+
+PDC_MIRROR *PDC_mirror_attach(const char *name)
+{
+    return (PDC_MIRROR *)NULL;
+}
+
+unsigned long PDC_mirror_begin(PDC_MIRROR *m)
+{
+    return 1;
+}
+
+bool PDC_mirror_valid(PDC_MIRROR *m, unsigned long seq)
+{
+    return FALSE;
+}
+
+void PDC_mirror_detach(PDC_MIRROR *m)
+{
+}
+
+#endif
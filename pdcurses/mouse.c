@@ -69,14 +69,28 @@ mouse
 
    mouseinterval() sets the timeout for a mouse click. On all current
    platforms, PDCurses receives mouse button press and release events,
-   but must synthesize click events. It does this by checking whether a
-   release event is queued up after a press event. If it gets a press
-   event, and there are no more events waiting, it will wait for the
-   timeout interval, then check again for a release. A press followed by
-   a release is reported as BUTTON_CLICKED; otherwise it's passed
-   through as BUTTON_PRESSED. The default timeout is 150ms; valid values
-   are 0 (no clicks reported) through 1000ms. In x11, the timeout can
-   also be set via the clickPeriod resource. The return value from
+   but must synthesize click events. In X11 and SDL, presses are
+   reported immediately as BUTTON_PRESSED; if the matching release
+   arrives within the timeout interval (as measured by the event
+   timestamps), it's reported as BUTTON_CLICKED instead of
+   BUTTON_RELEASED. A further press and release, each within the
+   interval, is reported as BUTTON_DOUBLE_CLICKED, and then as
+   BUTTON_TRIPLE_CLICKED. Other platforms check whether a release event
+   is queued up after a press event, waiting for up to the timeout
+   interval, and report BUTTON_CLICKED in place of the press if one is
+   found. The default timeout is 150ms; valid values are 0 (no clicks
+   reported) through 1000ms. In x11, the timeout can
+   also be set via the clickPeriod resource.
+
+   So in X11 and SDL, a quick press and release of button 1, with both
+   BUTTON1_PRESSED and BUTTON1_CLICKED in the mask (as with
+   ALL_MOUSE_EVENTS), gives two KEY_MOUSE events: BUTTON_PRESSED, then
+   BUTTON_CLICKED. Earlier versions gave only the BUTTON_CLICKED, and
+   the other platforms still do. A program that wants one event per
+   click, everywhere, should leave BUTTON1_PRESSED out of the mask;
+   presses that aren't asked for are never reported, so the click
+   arrives alone, as before. A slow press and release gives
+   BUTTON_PRESSED and BUTTON_RELEASED, as before. The return value from
    mouseinterval() is the old timeout. To check the old value without
    setting a new one, call it with a parameter of -1. Note that although
    there's no classic equivalent for this function (apart from the
@@ -140,8 +154,6 @@ mouse
 
 #include <string.h>
 
-static bool ungot = FALSE;
-
 int mouse_set(mmask_t mbe)
 {
     PDC_LOG(("mouse_set() - called: event %x\n", mbe));
@@ -150,7 +162,7 @@ int mouse_set(mmask_t mbe)
         return ERR;
 
     SP->_trap_mbe = mbe;
-    return PDC_mouse_set();
+    return SP->opaque->headless ? OK : PDC_mouse_set();
 }
 
 int mouse_on(mmask_t mbe)
@@ -161,7 +173,7 @@ int mouse_on(mmask_t mbe)
         return ERR;
 
     SP->_trap_mbe |= mbe;
-    return PDC_mouse_set();
+    return SP->opaque->headless ? OK : PDC_mouse_set();
 }
 
 int mouse_off(mmask_t mbe)
@@ -172,7 +184,7 @@ int mouse_off(mmask_t mbe)
         return ERR;
 
     SP->_trap_mbe &= ~mbe;
-    return PDC_mouse_set();
+    return SP->opaque->headless ? OK : PDC_mouse_set();
 }
 
 int request_mouse_pos(void)
@@ -312,7 +324,7 @@ int nc_getmouse(MEVENT *event)
     if (!event || !SP)
         return ERR;
 
-    ungot = FALSE;
+    SP->opaque->ungot = FALSE;
 
     request_mouse_pos();
 
@@ -337,6 +349,8 @@ int nc_getmouse(MEVENT *event)
                 bstate |= (BUTTON1_CLICKED << shf);
             else if (button == BUTTON_DOUBLE_CLICKED)
                 bstate |= (BUTTON1_DOUBLE_CLICKED << shf);
+            else if (button == BUTTON_TRIPLE_CLICKED)
+                bstate |= (BUTTON1_TRIPLE_CLICKED << shf);
 
             button = Mouse_status.button[i] & BUTTON_MODIFIER_MASK;
 
@@ -368,10 +382,10 @@ int ungetmouse(MEVENT *event)
 
     PDC_LOG(("ungetmouse() - called\n"));
 
-    if (!event || ungot)
+    if (!event || !SP || SP->opaque->ungot)
         return ERR;
 
-    ungot = TRUE;
+    SP->opaque->ungot = TRUE;
 
     SP->mouse_status.x = event->x;
     SP->mouse_status.y = event->y;
@@ -385,7 +399,8 @@ int ungetmouse(MEVENT *event)
         short button = 0;
 
         if (bstate & ((BUTTON1_RELEASED | BUTTON1_PRESSED |
-            BUTTON1_CLICKED | BUTTON1_DOUBLE_CLICKED) << shf))
+            BUTTON1_CLICKED | BUTTON1_DOUBLE_CLICKED |
+            BUTTON1_TRIPLE_CLICKED) << shf))
         {
             SP->mouse_status.changes |= 1 << i;
 
@@ -395,6 +410,8 @@ int ungetmouse(MEVENT *event)
                 button = BUTTON_CLICKED;
             if (bstate & (BUTTON1_DOUBLE_CLICKED << shf))
                 button = BUTTON_DOUBLE_CLICKED;
+            if (bstate & (BUTTON1_TRIPLE_CLICKED << shf))
+                button = BUTTON_TRIPLE_CLICKED;
 
             if (bstate & BUTTON_MODIFIER_SHIFT)
                 button |= PDC_BUTTON_SHIFT;
@@ -417,5 +434,52 @@ int ungetmouse(MEVENT *event)
 
 bool has_mouse(void)
 {
-    return PDC_has_mouse();
+    return (SP && SP->opaque->headless) ? FALSE : PDC_has_mouse();
+}
+
+/* Work out the action to report for a press or release of button (1 to
+   3), given the event's timestamp in milliseconds. Presses are always
+   reported as such; a release that follows its press within
+   SP->mouse_wait is reported as a click, and successive clicks within
+   the interval become double and triple clicks. Nothing here waits for
+   further events, so the port can deliver the result right away. */
+
+short PDC_mouse_click(int button, bool pressed, unsigned long msec)
+{
+    unsigned long elapsed;
+    short clicks;
+
+    PDC_LOG(("PDC_mouse_click() - called: %d %d %lu\n",
+             button, pressed, msec));
+
+    if (!SP || button < 1 || button > 3)
+        return pressed ? BUTTON_PRESSED : BUTTON_RELEASED;
+
+    button--;
+
+    elapsed = msec - SP->mouse_time[button];
+    clicks = SP->mouse_clicks[button];
+
+    SP->mouse_time[button] = msec;
+
+    if (pressed)
+    {
+        /* a press too long after the last click starts a new series */
+
+        if (elapsed > (unsigned long)SP->mouse_wait)
+            SP->mouse_clicks[button] = 0;
+
+        return BUTTON_PRESSED;
+    }
+
+    if (!SP->mouse_wait || elapsed > (unsigned long)SP->mouse_wait)
+    {
+        SP->mouse_clicks[button] = 0;
+        return BUTTON_RELEASED;
+    }
+
+    SP->mouse_clicks[button] = clicks = clicks % 3 + 1;
+
+    return (clicks == 1) ? BUTTON_CLICKED :
+           ((clicks == 2) ? BUTTON_DOUBLE_CLICKED : BUTTON_TRIPLE_CLICKED);
 }
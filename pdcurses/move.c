@@ -56,7 +56,8 @@ int mvcur(int oldrow, int oldcol, int newrow, int newcol)
     if (!SP || newrow < 0 || newrow >= LINES || newcol < 0 || newcol >= COLS)
         return ERR;
 
-    PDC_gotoyx(newrow, newcol);
+    if (!SP->opaque->headless)
+        PDC_gotoyx(newrow, newcol);
     SP->cursrow = newrow;
     SP->curscol = newcol;
 
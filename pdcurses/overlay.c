@@ -46,71 +46,307 @@ overlay
 
 **man-end****************************************************************/
 
+#include <string.h>
+
+/* Vector kernels for _blend(), where the compiler can build them: SSE2
+   for any x86 it targets with it (all of x86-64), and AVX2, picked at
+   run time if the CPU has it */
+
+#if defined(__GNUC__) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__))
+# define _BLEND_SSE2
+# include <emmintrin.h>
+# if __GNUC__ >= 5 || defined(__clang__)
+#  define _BLEND_AVX2
+#  include <immintrin.h>
+# endif
+#endif
+
 /* Thanks to Andreas Otte <venn@@uni-paderborn.de> for the
    corrected overlay()/overwrite() behavior. */
 
-static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
-                     int src_tc, int src_br, int src_bc, int dst_tr,
-                     int dst_tc, bool _overlay)
+#define _BLANK(ch) (((ch) & A_CHARTEXT) == ' ')
+#define _BLOCK (PDC_CHUNK * 4)  /* cells compared at once by _same() */
+
+/* Copy n cells to line y of dst_w, from column x, one at a time; for
+   source and destination lines that share storage, where the order of
+   the copies matters */
+
+static void _copy_cells(WINDOW *dst_w, int y, int x, const chtype *src,
+                        int n, bool _overlay)
 {
-    int col, line, y1, fc, *minchng, *maxchng;
-    chtype *w1ptr, *w2ptr;
+    chtype *dst = dst_w->_y[y] + x;
+    int col;
 
-    int lc = 0;
-    int xdiff = src_bc - src_tc;
-    int ydiff = src_br - src_tr;
+    for (col = 0; col < n; col++)
+        if (src[col] != dst[col] && !(_overlay && _BLANK(src[col])))
+        {
+            dst[col] = src[col];
+            PDC_touch_span(dst_w, y, x + col, x + col);
+        }
+}
 
-    if (!src_w || !dst_w)
-        return ERR;
+/* Index of the first cell at or after i where a and b differ, or n.
+   This goes a block at a time, through memcmp(), which C libraries
+   tune for the CPU. */
 
-    minchng = dst_w->_firstch;
-    maxchng = dst_w->_lastch;
+static int _same(const chtype *a, const chtype *b, int i, int n)
+{
+    while (n - i >= _BLOCK &&
+           !memcmp(a + i, b + i, _BLOCK * sizeof(chtype)))
+        i += _BLOCK;
+
+    while (i < n && a[i] == b[i])
+        i++;
+
+    return i;
+}
+
+/* Add columns from through to of line y, which changed, to the span
+   being collected in *first and *last. A span runs on past unchanged
+   cells as long as it covers no more chunks than marking each cell
+   would; otherwise the old one is marked, and a new one begun. */
 
-    for (y1 = 0; y1 < dst_tr; y1++)
+static void _mark(WINDOW *dst_w, int y, int from, int to,
+                  int *first, int *last)
+{
+    if (*first != _NO_CHANGE && from / PDC_CHUNK > *last / PDC_CHUNK + 1)
     {
-        minchng++;
-        maxchng++;
+        PDC_touch_span(dst_w, y, *first, *last);
+        *first = _NO_CHANGE;
     }
 
-    for (line = 0; line < ydiff; line++)
-    {
-        w1ptr = src_w->_y[line + src_tr] + src_tc;
-        w2ptr = dst_w->_y[line + dst_tr] + dst_tc;
+    if (*first == _NO_CHANGE)
+        *first = from;
 
-        fc = _NO_CHANGE;
+    *last = to;
+}
 
-        for (col = 0; col < xdiff; col++)
-        {
-            if ((*w1ptr) != (*w2ptr) &&
-                !((*w1ptr & A_CHARTEXT) == ' ' && _overlay))
-            {
-                *w2ptr = *w1ptr;
+/* Blend cells i through n - 1 of src into line y of dst_w, from column
+   x, a cell at a time; stretches that already match are skipped a
+   block at a time */
 
-                if (fc == _NO_CHANGE)
-                    fc = col + dst_tc;
+static void _blend_cells(WINDOW *dst_w, int y, int x, const chtype *src,
+                         int i, int n, bool _overlay, int *first,
+                         int *last)
+{
+    chtype *dst = dst_w->_y[y] + x;
+    int same = 0;
 
-                lc = col + dst_tc;
+    for (; i < n; i++)
+    {
+        /* after a block's worth of matches, more probably follow */
+
+        if (src[i] == dst[i])
+        {
+            if (++same == _BLOCK)
+            {
+                i = _same(src, dst, i + 1, n) - 1;
+                same = 0;
             }
 
-            w1ptr++;
-            w2ptr++;
+            continue;
         }
 
-        if (*minchng == _NO_CHANGE)
-        {
-            *minchng = fc;
-            *maxchng = lc;
-        }
-        else if (fc != _NO_CHANGE)
-        {
-            if (fc < *minchng)
-                *minchng = fc;
-            if (lc > *maxchng)
-                *maxchng = lc;
-        }
+        same = 0;
+
+        if (_overlay && _BLANK(src[i]))
+            continue;
+
+        dst[i] = src[i];
+        _mark(dst_w, y, x + i, x + i, first, last);
+    }
+}
+
+/* The kernels: the same as _copy_cells(), for lines that don't
+   overlap, with changed cells marked a span at a time. The scalar one
+   is used where there's no vector one. */
+
+static void _blend_scalar(WINDOW *dst_w, int y, int x, const chtype *src,
+                          int n, bool _overlay)
+{
+    int first = _NO_CHANGE, last = 0;
+
+    _blend_cells(dst_w, y, x, src, 0, n, _overlay, &first, &last);
+
+    if (first != _NO_CHANGE)
+        PDC_touch_span(dst_w, y, first, last);
+}
+
+/* The vector kernels take a register of cells at a time. A lane is
+   kept if its source cell matches the destination, or (for overlay)
+   is a blank; the others are blended in, and the first and last of
+   them come from the compare mask. A register spans at most two
+   chunks, so marking them as one span is what _mark() would do cell
+   by cell. */
+
+#ifdef _BLEND_SSE2
+# ifdef CHTYPE_64
+#  define _LANES 2
+#  define _SET1(v) _mm_set1_epi64x(v)
+#  define _MASK(v) _mm_movemask_pd(_mm_castsi128_pd(v))
+
+/* SSE2 has no 64-bit compare: both halves must match */
+
+static __m128i _cmpeq(__m128i a, __m128i b)
+{
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+# else
+#  define _LANES 4
+#  define _SET1(v) _mm_set1_epi32((int)(v))
+#  define _MASK(v) _mm_movemask_ps(_mm_castsi128_ps(v))
+#  define _cmpeq _mm_cmpeq_epi32
+# endif
+
+static void _blend_sse2(WINDOW *dst_w, int y, int x, const chtype *src,
+                        int n, bool _overlay)
+{
+    chtype *dst = dst_w->_y[y] + x;
+    __m128i text = _SET1(A_CHARTEXT), blank = _SET1(' ');
+    int i, bits, first = _NO_CHANGE, last = 0;
+
+    for (i = 0; i + _LANES <= n; i += _LANES)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i keep = _cmpeq(s, d);
+
+        if (_overlay)
+            keep = _mm_or_si128(keep,
+                                _cmpeq(_mm_and_si128(s, text), blank));
+
+        bits = ~_MASK(keep) & ((1 << _LANES) - 1);
+        if (!bits)
+            continue;
+
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_or_si128(_mm_and_si128(keep, d),
+                                      _mm_andnot_si128(keep, s)));
+
+        _mark(dst_w, y, x + i + __builtin_ctz(bits),
+              x + i + 31 - __builtin_clz(bits), &first, &last);
+    }
+
+    _blend_cells(dst_w, y, x, src, i, n, _overlay, &first, &last);
+
+    if (first != _NO_CHANGE)
+        PDC_touch_span(dst_w, y, first, last);
+}
+
+# undef _LANES
+# undef _SET1
+# undef _MASK
+# ifndef CHTYPE_64
+#  undef _cmpeq
+# endif
+#endif
+
+#ifdef _BLEND_AVX2
+# ifdef CHTYPE_64
+#  define _LANES 4
+#  define _SET1(v) _mm256_set1_epi64x(v)
+#  define _MASK(v) _mm256_movemask_pd(_mm256_castsi256_pd(v))
+#  define _CMPEQ _mm256_cmpeq_epi64
+# else
+#  define _LANES 8
+#  define _SET1(v) _mm256_set1_epi32((int)(v))
+#  define _MASK(v) _mm256_movemask_ps(_mm256_castsi256_ps(v))
+#  define _CMPEQ _mm256_cmpeq_epi32
+# endif
+
+__attribute__((target("avx2")))
+static void _blend_avx2(WINDOW *dst_w, int y, int x, const chtype *src,
+                        int n, bool _overlay)
+{
+    chtype *dst = dst_w->_y[y] + x;
+    __m256i text = _SET1(A_CHARTEXT), blank = _SET1(' ');
+    int i, bits, first = _NO_CHANGE, last = 0;
+
+    for (i = 0; i + _LANES <= n; i += _LANES)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i keep = _CMPEQ(s, d);
+
+        if (_overlay)
+            keep = _mm256_or_si256(keep,
+                                   _CMPEQ(_mm256_and_si256(s, text), blank));
+
+        bits = ~_MASK(keep) & ((1 << _LANES) - 1);
+        if (!bits)
+            continue;
+
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_blendv_epi8(s, d, keep));
+
+        _mark(dst_w, y, x + i + __builtin_ctz(bits),
+              x + i + 31 - __builtin_clz(bits), &first, &last);
+    }
+
+    _blend_cells(dst_w, y, x, src, i, n, _overlay, &first, &last);
+
+    if (first != _NO_CHANGE)
+        PDC_touch_span(dst_w, y, first, last);
+}
+
+# undef _LANES
+# undef _SET1
+# undef _MASK
+# undef _CMPEQ
+#endif
+
+/* Pick the best kernel the CPU can run, on the first call */
+
+static void _blend_pick(WINDOW *, int, int, const chtype *, int, bool);
+
+static void (*_blend)(WINDOW *, int, int, const chtype *, int, bool) =
+    _blend_pick;
+
+static void _blend_pick(WINDOW *dst_w, int y, int x, const chtype *src,
+                        int n, bool _overlay)
+{
+    _blend = _blend_scalar;
+
+#ifdef _BLEND_SSE2
+    _blend = _blend_sse2;
+#endif
+#ifdef _BLEND_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        _blend = _blend_avx2;
+#endif
+
+    _blend(dst_w, y, x, src, n, _overlay);
+}
+
+static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
+                     int src_tc, int src_br, int src_bc, int dst_tr,
+                     int dst_tc, bool _overlay)
+{
+    int line;
+    int xdiff = src_bc - src_tc;
+    int ydiff = src_br - src_tr;
+
+    if (!src_w || !dst_w)
+        return ERR;
+
+    for (line = 0; line < ydiff; line++)
+    {
+        const chtype *w1ptr = src_w->_y[line + src_tr] + src_tc;
+        const chtype *w2ptr = dst_w->_y[line + dst_tr] + dst_tc;
+
+        if (w1ptr == w2ptr)
+            continue;
+
+        /* a window copied onto itself, or onto a subwindow of it */
 
-        minchng++;
-        maxchng++;
+        if (w1ptr < w2ptr + xdiff && w2ptr < w1ptr + xdiff)
+            _copy_cells(dst_w, line + dst_tr, dst_tc, w1ptr, xdiff,
+                        _overlay);
+        else
+            _blend(dst_w, line + dst_tr, dst_tc, w1ptr, xdiff, _overlay);
     }
 
     return OK;
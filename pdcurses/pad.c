@@ -21,6 +21,12 @@ pad
 
     bool is_pad(const WINDOW *pad);
 
+    WINDOW *newvpad(int nlines, int ncols, int cache,
+                    int (*fill)(WINDOW *pad, int line, chtype *cells,
+                                void *arg), void *arg);
+    int vpad_invalidate(WINDOW *pad, int line, int n);
+    int vpad_resize(WINDOW *pad, int nlines);
+
 ### Description
 
    A pad is a special kind of window, which is not restricted by the
@@ -42,7 +48,13 @@ pad
    When using sub-pads, you may need to call touchwin() before calling
    prefresh().
 
-   pnoutrefresh() copies the specified pad to the virtual screen.
+   pnoutrefresh() copies the specified pad to the virtual screen. When
+   it's given the same position and screen rectangle as last time, only
+   the lines and columns changed in the pad since then are copied; so,
+   as with wnoutrefresh(), if something else has been drawn over that
+   rectangle in between, call touchwin() on the pad first. When only
+   the position in the pad differs, the screen is told how its contents
+   moved, so that it can scroll what's already shown.
 
    prefresh() calls pnoutrefresh(), followed by doupdate().
 
@@ -57,9 +69,32 @@ pad
 
    is_pad() reports whether the specified window is a pad.
 
+   newvpad() creates a virtual pad, of nlines lines and ncols columns,
+   whose contents come from the application rather than being stored in
+   it. When pnoutrefresh() needs a line that it doesn't have, it calls
+   fill() with the pad, the line number, an array of ncols cells set to
+   the pad's background, and arg; fill() stores the line's contents in
+   the array, and returns OK (or ERR, to leave the line blank). The
+   lines most recently used are kept, up to cache of them (LINES if
+   cache is 0 or less), with the least recently used one giving way to
+   a new line, so memory depends on the size of the view, not on
+   nlines. A virtual pad is otherwise shown like any pad, but it isn't
+   drawn into, and getmaxy() gives the size of its cache. Its lines may
+   come from anywhere -- a file mapped into memory, say, or a log that
+   keeps growing.
+
+   vpad_invalidate() tells a virtual pad that n of its lines, starting
+   at line, have changed, so that they're fetched again when next
+   shown; if n is negative, the rest of the pad is included.
+
+   vpad_resize() changes the number of lines in a virtual pad, as when
+   lines are added to the end of a log; any lines cut off are dropped.
+
 ### Return Value
 
-   All functions except is_pad() return OK on success and ERR on error.
+   newvpad() returns a pointer to the new pad, or NULL on failure. All
+   other functions except is_pad() return OK on success and ERR on
+   error.
 
 ### Portability
                              X/Open  ncurses  NetBSD
@@ -70,9 +105,13 @@ pad
     pechochar                   Y       Y       Y
     pecho_wchar                 Y       Y       Y
     is_pad                      -       Y       Y
+    newvpad                     -       -       -
+    vpad_invalidate             -       -       -
+    vpad_resize                 -       -       -
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 /* save values for pechochar() */
@@ -80,6 +119,25 @@ pad
 static int save_pminrow, save_pmincol;
 static int save_sminrow, save_smincol, save_smaxrow, save_smaxcol;
 
+/* A virtual pad's window holds only its cache: each of its lines is a
+   slot, holding one line of the pad. Slots are found by pad line
+   through hash chains, and the one used least recently is the one
+   refilled. A refilled slot is touched, so that pnoutrefresh() copies
+   it even when the view hasn't moved. */
+
+struct _vpad_t
+{
+    int (*fill)(WINDOW *, int, chtype *, void *);
+    void *arg;
+    int lines;              /* lines in the pad */
+    int *line;              /* pad line in each slot, or -1 */
+    unsigned long *used;    /* when each slot was last used */
+    unsigned long clock;
+    int *head;              /* first slot in each hash chain, or -1 */
+    int *next;              /* next slot in the same chain, or -1 */
+    int mask;               /* hash chains - 1 */
+};
+
 WINDOW *newpad(int nlines, int ncols)
 {
     WINDOW *win;
@@ -96,6 +154,7 @@ WINDOW *newpad(int nlines, int ncols)
     werase(win);
 
     win->_flags = _PAD;
+    win->_pady = win->_padx = -1;
 
     /* save default values in case pechochar() is the first call to
        prefresh(). */
@@ -118,7 +177,7 @@ WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     PDC_LOG(("subpad() - called: lines=%d cols=%d begy=%d begx=%d\n",
              nlines, ncols, begy, begx));
 
-    if (!orig || !(orig->_flags & _PAD))
+    if (!orig || !(orig->_flags & _PAD) || orig->_vpad)
         return (WINDOW *)NULL;
 
     /* make sure window fits inside the original one */
@@ -151,6 +210,7 @@ WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
         win->_y[i] = orig->_y[begy + i] + begx;
 
     win->_flags = _SUBPAD;
+    win->_pady = win->_padx = -1;
 
     /* save default values in case pechochar() is the first call
        to prefresh(). */
@@ -176,11 +236,178 @@ int prefresh(WINDOW *win, int py, int px, int sy1, int sx1, int sy2, int sx2)
     return OK;
 }
 
+/* Copy cells first through last of pad line pline to screen line
+   sline, offset by shift */
+
+static void _copy_cells(WINDOW *w, int pline, int first, int last,
+                        int sline, int shift)
+{
+    memcpy(curscr->_y[sline] + first + shift, w->_y[pline] + first,
+           (last - first + 1) * sizeof(chtype));
+
+    PDC_touch_span(curscr, sline, first + shift, last + shift);
+}
+
+/* Take slot s out of its hash chain, and mark it empty */
+
+static void _vpad_drop(struct _vpad_t *vp, int s)
+{
+    int *link = vp->head + (vp->line[s] & vp->mask);
+
+    while (*link != s)
+        link = vp->next + *link;
+
+    *link = vp->next[s];
+    vp->line[s] = -1;
+}
+
+/* Find the slot holding pad line pline, filling one if needed */
+
+static int _vpad_slot(WINDOW *w, int pline)
+{
+    struct _vpad_t *vp = w->_vpad;
+    int s, x;
+
+    for (s = vp->head[pline & vp->mask]; s != -1; s = vp->next[s])
+        if (vp->line[s] == pline)
+        {
+            vp->used[s] = ++vp->clock;
+            return s;
+        }
+
+    /* not there -- take an empty slot, or the least recently used */
+
+    for (s = 0, x = 1; x < w->_maxy && vp->line[s] != -1; x++)
+        if (vp->line[x] == -1 || vp->used[x] < vp->used[s])
+            s = x;
+
+    if (vp->line[s] != -1)
+        _vpad_drop(vp, s);
+
+    vp->line[s] = pline;
+    vp->next[s] = vp->head[pline & vp->mask];
+    vp->head[pline & vp->mask] = s;
+    vp->used[s] = ++vp->clock;
+
+    for (x = 0; x < w->_maxx; x++)
+        w->_y[s][x] = w->_bkgd;
+
+    if (vp->fill(w, pline, w->_y[s], vp->arg) == ERR)
+        for (x = 0; x < w->_maxx; x++)
+            w->_y[s][x] = w->_bkgd;
+
+    PDC_touch_span(w, s, 0, w->_maxx - 1);
+
+    return s;
+}
+
+void PDC_vpad_free(WINDOW *w)
+{
+    struct _vpad_t *vp = w->_vpad;
+
+    free(vp->line);
+    free(vp->used);
+    free(vp->head);
+    free(vp->next);
+    free(vp);
+
+    w->_vpad = NULL;
+}
+
+WINDOW *newvpad(int nlines, int ncols, int cache,
+                int (*fill)(WINDOW *, int, chtype *, void *), void *arg)
+{
+    WINDOW *win;
+    struct _vpad_t *vp;
+    int i, chains;
+
+    PDC_LOG(("newvpad() - called: lines=%d cols=%d cache=%d\n",
+             nlines, ncols, cache));
+
+    if (!fill || nlines < 1 || ncols < 1)
+        return (WINDOW *)NULL;
+
+    if (cache < 1)
+        cache = LINES;
+
+    win = newpad(cache, ncols);
+    if (!win)
+        return (WINDOW *)NULL;
+
+    for (chains = 1; chains < cache; chains <<= 1)
+        ;
+
+    vp = calloc(1, sizeof(struct _vpad_t));
+    if (vp)
+    {
+        win->_vpad = vp;
+
+        vp->line = malloc(cache * sizeof(int));
+        vp->used = calloc(cache, sizeof(unsigned long));
+        vp->next = malloc(cache * sizeof(int));
+        vp->head = malloc(chains * sizeof(int));
+    }
+
+    if (!vp || !vp->line || !vp->used || !vp->next || !vp->head)
+    {
+        delwin(win);
+        return (WINDOW *)NULL;
+    }
+
+    for (i = 0; i < cache; i++)
+        vp->line[i] = -1;
+
+    for (i = 0; i < chains; i++)
+        vp->head[i] = -1;
+
+    vp->fill = fill;
+    vp->arg = arg;
+    vp->lines = nlines;
+    vp->mask = chains - 1;
+
+    win->_leaveit = TRUE;    /* the cursor isn't on any line of the pad */
+
+    save_smaxrow = min(LINES, nlines) - 1;
+
+    return win;
+}
+
+int vpad_invalidate(WINDOW *pad, int line, int n)
+{
+    struct _vpad_t *vp;
+    int s;
+
+    PDC_LOG(("vpad_invalidate() - called: line=%d n=%d\n", line, n));
+
+    if (!pad || !pad->_vpad || line < 0)
+        return ERR;
+
+    vp = pad->_vpad;
+
+    for (s = 0; s < pad->_maxy; s++)
+        if (vp->line[s] >= line && (n < 0 || vp->line[s] < line + n))
+            _vpad_drop(vp, s);
+
+    return OK;
+}
+
+int vpad_resize(WINDOW *pad, int nlines)
+{
+    PDC_LOG(("vpad_resize() - called: lines=%d\n", nlines));
+
+    if (!pad || !pad->_vpad || nlines < 1)
+        return ERR;
+
+    pad->_vpad->lines = nlines;
+
+    return vpad_invalidate(pad, nlines, -1);
+}
+
 int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
 {
-    int num_cols;
-    int sline = sy1;
-    int pline = py;
+    int num_cols, nlines;
+    int sline, pline;
+    bool same;
 
     PDC_LOG(("pnoutrefresh() - called\n"));
 
@@ -201,28 +428,53 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
 
     num_cols = min((sx2 - sx1 + 1), (w->_maxx - px));
 
-    while (sline <= sy2)
+    /* if the pad goes to the same screen rectangle as last time, and
+       nothing calls for a full redraw, then only its changes need to be
+       copied -- unless it's been scrolled, in which case the screen can
+       move what it shows to match */
+
+    same = !w->_clear && !curscr->_clear &&
+           sy1 == w->_padtop && sx1 == w->_padleft &&
+           sy2 == w->_padbottom && sx2 == w->_padright;
+
+    if (same && (py != w->_pady || px != w->_padx))
     {
-        if (pline < w->_maxy)
-        {
-            memcpy(curscr->_y[sline] + sx1, w->_y[pline] + px,
-                   num_cols * sizeof(chtype));
+        PDC_scroll_hint(sy1, sx1, sy2, sx2, py - w->_pady, px - w->_padx);
+        same = FALSE;
+    }
 
-            if ((curscr->_firstch[sline] == _NO_CHANGE)
-                || (curscr->_firstch[sline] > sx1))
-                curscr->_firstch[sline] = sx1;
+    /* a virtual pad's lines are looked up in its cache, and each one
+       used is copied before the next can take its slot */
 
-            if (sx2 > curscr->_lastch[sline])
-                curscr->_lastch[sline] = sx2;
+    nlines = w->_vpad ? w->_vpad->lines : w->_maxy;
 
-            w->_firstch[pline] = _NO_CHANGE; /* updated now */
-            w->_lastch[pline] = _NO_CHANGE;  /* updated now */
+    for (sline = sy1, pline = py; sline <= sy2 && pline < nlines;
+         sline++, pline++)
+    {
+        int last = px + num_cols - 1;
+        int row = w->_vpad ? _vpad_slot(w, pline) : pline;
+
+        if (same)
+        {
+            int x, end;
+
+            for (x = px; PDC_next_change(w, row, &x, &end) && x <= last;
+                 x = end + 1)
+                _copy_cells(w, row, x, min(end, last), sline, sx1 - px);
         }
+        else if (num_cols > 0)
+            _copy_cells(w, row, px, last, sline, sx1 - px);
 
-        sline++;
-        pline++;
+        PDC_untouch_line(w, row);       /* updated now */
     }
 
+    w->_pady = py;
+    w->_padx = px;
+    w->_padtop = sy1;
+    w->_padleft = sx1;
+    w->_padbottom = sy2;
+    w->_padright = sx2;
+
     if (w->_clear)
     {
         w->_clear = FALSE;
@@ -227,8 +227,15 @@ static void _override(PANEL *pan, int show)
         Touchpan(&_stdscr_pseudo_panel);
     }
     else if (show == -1)
+    {
+        /* nothing to pass on if neither window has changed */
+
+        if (!pan->win->_touched && !stdscr->_touched)
+            return;
+
         while (tobs && (tobs->pan != pan))
             tobs = tobs->above;
+    }
 
     while (tobs)
     {
@@ -0,0 +1,282 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+record
+------
+
+### Synopsis
+
+    int PDC_record(FILE *filep);
+
+### Description
+
+   PDC_record() starts recording the session to filep, which must be
+   open for binary writing: from then on, every change that doupdate()
+   makes to the screen, and every key that wgetch() returns, is
+   appended to it, with the time it happened. The recording begins
+   with what's on the screen already. PDC_record(NULL) stops recording
+   and flushes the file, but doesn't close it; delscreen() also stops
+   recording. A recording can be played back with the replay demo,
+   through any port or with no screen at all, at its original speed
+   or as fast as possible.
+
+   The file starts with the four bytes "PDCr", a format version (1),
+   and the size of a chtype in bytes. Then come records, each a type
+   byte followed by numbers -- unsigned values in 7-bit groups, low
+   group first, with the top bit set on all but the last; signed ones
+   as 2n for n >= 0 and -2n - 1 for n < 0 -- and cells, as chtypes
+   stored low byte first:
+
+    S lines cols                      the screen's size changed
+    D y x n cell...                   n cells, from (y, x)
+    R y x n cell                      n copies of a cell, from (y, x)
+    M top left bottom right dy dx     the rectangle shows what was dy
+                                      lines down and dx columns right
+                                      (signed), as in a scroll
+    F ms y x visibility               end of a frame; cursor position
+    K ms key                          wgetch() returned key
+
+   ms is the time in milliseconds since the previous F or K record.
+   After an S record, the whole screen is given in D and R records.
+
+### Return Value
+
+   PDC_record() returns OK, or ERR if it can't write to filep.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_record                  -       -       -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+
+#define _MINRUN 8       /* repeats shorter than this are stored as-is */
+
+struct _pdc_record
+{
+    FILE *fp;
+    unsigned long ms;       /* time of the last F or K record */
+    int lines, cols;        /* size last recorded */
+    int cury, curx, visibility;
+    bool changed;           /* recorded a change since the last F */
+};
+
+static void _put_num(FILE *fp, unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        putc((int)(n & 0x7f) | 0x80, fp);
+        n >>= 7;
+    }
+
+    putc((int)n, fp);
+}
+
+static void _put_signed(FILE *fp, long n)
+{
+    _put_num(fp, (n < 0) ? -2 * (unsigned long)n - 1 :
+                           2 * (unsigned long)n);
+}
+
+static void _put_cell(FILE *fp, chtype ch)
+{
+    int i;
+
+    for (i = 0; i < (int)sizeof(chtype); i++, ch >>= 8)
+        putc((int)(ch & 0xff), fp);
+}
+
+static unsigned long _elapsed(struct _pdc_record *rec)
+{
+    unsigned long now = PDC_ms_count(), ms = now - rec->ms;
+
+    rec->ms = now;
+
+    return ms;
+}
+
+/* length of the run of identical cells at the start of cells */
+
+static int _run(const chtype *cells, int len)
+{
+    int n = 1;
+
+    while (n < len && cells[n] == cells[0])
+        n++;
+
+    return n;
+}
+
+static void _cells(struct _pdc_record *rec, int y, int x, int len,
+                   const chtype *srcp)
+{
+    int i = 0, j, n = 0;
+
+    while (i < len)
+    {
+        int start = i;
+
+        while (i < len && (n = _run(srcp + i, len - i)) < _MINRUN)
+            i += n;
+
+        if (i > start)
+        {
+            putc('D', rec->fp);
+            _put_num(rec->fp, y);
+            _put_num(rec->fp, x + start);
+            _put_num(rec->fp, i - start);
+
+            for (j = start; j < i; j++)
+                _put_cell(rec->fp, srcp[j]);
+        }
+
+        if (i < len)
+        {
+            putc('R', rec->fp);
+            _put_num(rec->fp, y);
+            _put_num(rec->fp, x + i);
+            _put_num(rec->fp, n);
+            _put_cell(rec->fp, srcp[i]);
+
+            i += n;
+        }
+    }
+
+    rec->changed = TRUE;
+}
+
+/* on a new screen size, record it, and everything shown */
+
+static void _check_size(struct _pdc_record *rec)
+{
+    int y;
+
+    if (rec->lines == SP->lines && rec->cols == SP->cols)
+        return;
+
+    rec->lines = SP->lines;
+    rec->cols = SP->cols;
+
+    putc('S', rec->fp);
+    _put_num(rec->fp, rec->lines);
+    _put_num(rec->fp, rec->cols);
+
+    for (y = 0; y < rec->lines; y++)
+        _cells(rec, y, 0, rec->cols, SP->lastscr->_y[y]);
+}
+
+int PDC_record(FILE *filep)
+{
+    struct _pdc_record *rec;
+
+    PDC_LOG(("PDC_record() - called\n"));
+
+    if (!SP)
+        return ERR;
+
+    rec = SP->opaque->record;
+
+    if (rec)
+    {
+        fflush(rec->fp);
+        free(rec);
+
+        SP->opaque->record = NULL;
+    }
+
+    if (!filep)
+        return OK;
+
+    rec = calloc(1, sizeof(struct _pdc_record));
+    if (!rec)
+        return ERR;
+
+    rec->fp = filep;
+    rec->ms = PDC_ms_count();
+    rec->visibility = -1;
+
+    fputs("PDCr", filep);
+    putc(1, filep);
+    putc((int)sizeof(chtype), filep);
+
+    SP->opaque->record = rec;
+
+    PDC_record_frame();
+
+    return SP->opaque->record ? OK : ERR;
+}
+
+/* Called from doupdate(), for each run of cells it sends to the port */
+
+void PDC_record_cells(int y, int x, int len, const chtype *srcp)
+{
+    struct _pdc_record *rec = SP->opaque->record;
+
+    _check_size(rec);
+    _cells(rec, y, x, len, srcp);
+}
+
+/* ...when the port has moved part of the screen */
+
+void PDC_record_move(int top, int left, int bottom, int right,
+                     int dy, int dx)
+{
+    struct _pdc_record *rec = SP->opaque->record;
+
+    _check_size(rec);
+
+    putc('M', rec->fp);
+    _put_num(rec->fp, top);
+    _put_num(rec->fp, left);
+    _put_num(rec->fp, bottom);
+    _put_num(rec->fp, right);
+    _put_signed(rec->fp, dy);
+    _put_signed(rec->fp, dx);
+
+    rec->changed = TRUE;
+}
+
+/* ...and at the end of each update; a write error stops recording */
+
+void PDC_record_frame(void)
+{
+    struct _pdc_record *rec = SP->opaque->record;
+
+    _check_size(rec);
+
+    if (rec->changed || rec->cury != SP->cursrow ||
+        rec->curx != SP->curscol || rec->visibility != SP->visibility)
+    {
+        rec->cury = SP->cursrow;
+        rec->curx = SP->curscol;
+        rec->visibility = SP->visibility;
+        rec->changed = FALSE;
+
+        putc('F', rec->fp);
+        _put_num(rec->fp, _elapsed(rec));
+        _put_num(rec->fp, rec->cury);
+        _put_num(rec->fp, rec->curx);
+        _put_num(rec->fp, rec->visibility);
+    }
+
+    if (ferror(rec->fp))
+    {
+        free(rec);
+        SP->opaque->record = NULL;
+    }
+}
+
+/* Called from wgetch() with each key it returns */
+
+void PDC_record_key(int key)
+{
+    struct _pdc_record *rec = SP->opaque->record;
+
+    putc('K', rec->fp);
+    _put_num(rec->fp, _elapsed(rec));
+    _put_num(rec->fp, (unsigned long)key);
+}
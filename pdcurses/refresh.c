@@ -15,6 +15,8 @@ refresh
     int doupdate(void);
     int redrawwin(WINDOW *win);
     int wredrawln(WINDOW *win, int beg_line, int num_lines);
+    int PDC_set_frame_rate(int fps);
+    int PDC_flush_frame(void);
 
 ### Description
 
@@ -40,6 +42,16 @@ refresh
    is the same as touchline(). In some other curses implementations,
    there's a subtle distinction, but it has no meaning in PDCurses.
 
+   PDC_set_frame_rate() caps the number of screen updates per second at
+   fps. With a cap in place, a doupdate() that comes too soon after the
+   last one only records that the screen needs updating; the changes
+   are sent out, all at once, by the next wgetch() or napms() that falls
+   after the interval has passed. This lets an application refresh as
+   often as it likes without flooding a slow display. A value of 0 (the
+   default) removes the cap, and sends any update still waiting.
+   PDC_flush_frame() updates the screen immediately, regardless of the
+   cap.
+
 ### Return Value
 
    All functions return OK on success and ERR on error.
@@ -52,11 +64,458 @@ refresh
     doupdate                    Y       Y       Y
     redrawwin                   Y       Y       Y
     wredrawln                   Y       Y       Y
+    PDC_set_frame_rate          -       -       -
+    PDC_flush_frame             -       -       -
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
+/* (Re)allocate the blink index for the current screen size. The index
+   starts out empty, matching a freshly erased SP->lastscr. */
+
+void PDC_blink_alloc(void)
+{
+    free(SP->opaque->blinkmap);
+
+    SP->opaque->blinkmap = calloc(SP->lines * PDC_BLINK_WORDS(SP->cols),
+                                  sizeof(unsigned long));
+    SP->opaque->blinkcount = 0;
+}
+
+/* Update the blink index for cells of row y, from first for len, that
+   are about to be copied from src to dest (in SP->lastscr) */
+
+static void _update_blink(int y, int first, int len, const chtype *src,
+                          const chtype *dest)
+{
+    unsigned long *row;
+    int x;
+
+    if (!SP->opaque->blinkmap)
+        return;
+
+    row = SP->opaque->blinkmap + y * PDC_BLINK_WORDS(SP->cols);
+
+    for (x = first; x < first + len; x++)
+        if ((src[x] ^ dest[x]) & A_BLINK)
+        {
+            unsigned long bit = 1UL << (x % PDC_BLINK_BITS);
+
+            if (src[x] & A_BLINK)
+            {
+                row[x / PDC_BLINK_BITS] |= bit;
+                SP->opaque->blinkcount++;
+            }
+            else
+            {
+                row[x / PDC_BLINK_BITS] &= ~bit;
+                SP->opaque->blinkcount--;
+            }
+        }
+}
+
+/* Redraw each run of blinking cells on the physical screen, for ports
+   that blink text themselves. Only rows with bits set in the blink
+   index are examined. */
+
+void PDC_redraw_blink(void)
+{
+    int y, w, words;
+
+    PDC_LOG(("PDC_redraw_blink() - called\n"));
+
+    if (!SP || !SP->opaque->blinkmap || !SP->opaque->blinkcount ||
+        SP->opaque->headless)
+        return;
+
+    words = PDC_BLINK_WORDS(SP->cols);
+
+    for (y = 0; y < SP->lines; y++)
+    {
+        unsigned long *row = SP->opaque->blinkmap + y * words;
+        const chtype *src = SP->lastscr->_y[y];
+        int start = -1;
+
+        for (w = 0; w < words; w++)
+        {
+            unsigned long bits = row[w];
+            int b, x = w * PDC_BLINK_BITS;
+
+            if (!bits && start == -1)
+                continue;
+
+            for (b = 0; b < PDC_BLINK_BITS && x < SP->cols; b++, x++)
+            {
+                if (bits & (1UL << b))
+                {
+                    if (start == -1)
+                        start = x;
+                }
+                else if (start != -1)
+                {
+                    PDC_transform_line(y, start, x - start, src + start);
+                    start = -1;
+                }
+            }
+        }
+
+        if (start != -1)
+            PDC_transform_line(y, start, SP->cols - start, src + start);
+    }
+}
+
+/* Frame deltas, for ports that draw on a thread of their own. The
+   port collects doupdate()'s output with PDC_frame_store(), then moves
+   it along with PDC_frame_take() under a lock. Taking merges into
+   whatever the destination hasn't drawn yet, so a renderer that falls
+   behind gets one coalesced frame instead of a backlog. */
+
+int PDC_frame_resize(PDC_FRAME *f, int lines, int cols)
+{
+    int y;
+
+    PDC_frame_free(f);
+
+    f->cells = calloc(lines * cols, sizeof(chtype));
+    f->fore = calloc(lines * cols, sizeof(short));
+    f->back = calloc(lines * cols, sizeof(short));
+    f->firstch = malloc(lines * sizeof(int));
+    f->lastch = malloc(lines * sizeof(int));
+
+    if (!f->cells || !f->fore || !f->back || !f->firstch || !f->lastch)
+    {
+        PDC_frame_free(f);
+        return ERR;
+    }
+
+    for (y = 0; y < lines; y++)
+        f->firstch[y] = f->lastch[y] = _NO_CHANGE;
+
+    f->lines = lines;
+    f->cols = cols;
+    f->cursrow = f->curscol = 0;
+    f->visibility = 0;
+    f->termattrs = SP->termattrs;
+    f->line_color = SP->line_color;
+    f->mono = SP->mono;
+    f->ready = FALSE;
+
+    return OK;
+}
+
+void PDC_frame_free(PDC_FRAME *f)
+{
+    free(f->cells);
+    free(f->fore);
+    free(f->back);
+    free(f->firstch);
+    free(f->lastch);
+
+    f->cells = NULL;
+    f->fore = f->back = NULL;
+    f->firstch = f->lastch = NULL;
+    f->lines = f->cols = 0;
+    f->ready = FALSE;
+}
+
+/* copy len cells into row y of f, starting at column x; with their
+   colors, if given, or else looked up now */
+
+static void _frame_put(PDC_FRAME *f, int y, int x, int len,
+                       const chtype *srcp, const short *fore,
+                       const short *back)
+{
+    int at = y * f->cols + x;
+
+    if (y < 0 || y >= f->lines || x < 0 || x >= f->cols)
+        return;
+
+    if (x + len > f->cols)
+        len = f->cols - x;
+
+    if (len <= 0)
+        return;
+
+    memcpy(f->cells + at, srcp, len * sizeof(chtype));
+
+    if (fore)
+    {
+        memcpy(f->fore + at, fore, len * sizeof(short));
+        memcpy(f->back + at, back, len * sizeof(short));
+    }
+    else
+    {
+        int i, fg = -1, bg = -1, pair = -1;
+
+        for (i = 0; i < len; i++)
+        {
+#ifdef A_RGB_COLOR
+            if (srcp[i] & A_RGB_COLOR)
+            {
+                f->fore[at + i] = f->back[at + i] = -1;
+                continue;
+            }
+#endif
+            if ((int)PAIR_NUMBER(srcp[i]) != pair)
+            {
+                pair = PAIR_NUMBER(srcp[i]);
+                extended_pair_content(pair, &fg, &bg);
+            }
+
+            f->fore[at + i] = fg;
+            f->back[at + i] = bg;
+        }
+    }
+
+    if (f->firstch[y] == _NO_CHANGE || x < f->firstch[y])
+        f->firstch[y] = x;
+
+    if (f->lastch[y] == _NO_CHANGE || x + len - 1 > f->lastch[y])
+        f->lastch[y] = x + len - 1;
+}
+
+/* record len cells of row y, starting at column x */
+
+void PDC_frame_store(PDC_FRAME *f, int y, int x, int len,
+                     const chtype *srcp)
+{
+    _frame_put(f, y, x, len, srcp, NULL, NULL);
+
+    f->termattrs = SP->termattrs;
+    f->line_color = SP->line_color;
+    f->mono = SP->mono;
+}
+
+/* move the changes recorded in src into dest, leaving src empty; dest
+   is then ready to be drawn */
+
+void PDC_frame_take(PDC_FRAME *dest, PDC_FRAME *src)
+{
+    int y;
+
+    for (y = 0; y < src->lines; y++)
+        if (src->firstch[y] != _NO_CHANGE)
+        {
+            int first = src->firstch[y];
+            int at = y * src->cols + first;
+
+            _frame_put(dest, y, first, src->lastch[y] - first + 1,
+                       src->cells + at, src->fore + at, src->back + at);
+
+            src->firstch[y] = src->lastch[y] = _NO_CHANGE;
+        }
+
+    dest->cursrow = src->cursrow;
+    dest->curscol = src->curscol;
+    dest->visibility = src->visibility;
+    dest->termattrs = src->termattrs;
+    dest->line_color = src->line_color;
+    dest->mono = src->mono;
+    dest->ready = TRUE;
+
+    src->ready = FALSE;
+}
+
+/* Does cell c use a pair marked stale by init_pair() or init_color()?
+   Direct-color cells use none. */
+
+#ifdef A_RGB_COLOR
+# define _STALE(stale, c) \
+    (!((c) & A_RGB_COLOR) && PDC_PAIR_TEST(stale, PAIR_NUMBER(c)))
+#else
+# define _STALE(stale, c) PDC_PAIR_TEST(stale, PAIR_NUMBER(c))
+#endif
+
+/* Find the first and last cells of row y on the physical screen that
+   use a stale pair */
+
+static bool _stale_span(int y, int *first, int *last)
+{
+    const chtype *dest = SP->lastscr->_y[y];
+    const unsigned long *stale = SP->opaque->pair_stale;
+    int x;
+
+    *first = *last = _NO_CHANGE;
+
+    for (x = 0; x < SP->cols; x++)
+        if (_STALE(stale, dest[x]))
+        {
+            if (*first == _NO_CHANGE)
+                *first = x;
+            *last = x;
+        }
+
+    return *first != _NO_CHANGE;
+}
+
+/* Make those cells of SP->lastscr that use a stale pair differ from
+   their counterparts in curscr, so that they're redrawn. The copy made
+   after drawing puts them right again. Only the character is altered,
+   to leave the blink index undisturbed. */
+
+static void _unmatch_stale(const chtype *src, chtype *dest, int first,
+                           int last)
+{
+    const unsigned long *stale = SP->opaque->pair_stale;
+    int x;
+
+    for (x = first; x <= last; x++)
+        if (src[x] == dest[x] && _STALE(stale, dest[x]))
+            dest[x] ^= 1;
+}
+
+void (*PDC_transform_frame)(const PDC_SPAN *, int) = NULL;
+
+/* Pass a changed run to the port: queue it for PDC_transform_frame(),
+   if the port has one, or else draw it now. If the queue can't grow,
+   the run is drawn now anyway. A headless screen only records it. */
+
+static void _draw(int *count, int y, int x, int len, const chtype *srcp)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+
+    if (o->record)
+        PDC_record_cells(y, x, len, srcp);
+
+    if (o->headless)
+        return;
+
+    if (PDC_transform_frame)
+    {
+        if (*count == o->span_max)
+        {
+            int newmax = o->span_max ? o->span_max * 2 : SP->lines * 2;
+            PDC_SPAN *tmp = realloc(o->spans, newmax * sizeof(PDC_SPAN));
+
+            if (tmp)
+            {
+                o->spans = tmp;
+                o->span_max = newmax;
+            }
+        }
+
+        if (*count < o->span_max)
+        {
+            PDC_SPAN *span = o->spans + (*count)++;
+
+            span->y = y;
+            span->x = x;
+            span->len = len;
+            span->srcp = srcp;
+            return;
+        }
+    }
+
+    PDC_transform_line(y, x, len, srcp);
+}
+
+int (*PDC_move_rect)(int, int, int, int, int, int) = NULL;
+
+/* Note that the rectangle (top, left)-(bottom, right) of curscr now
+   shows what was dy lines below and dx columns to the right of each
+   cell, for the next doupdate() to pass on to the port. Hints for the
+   same rectangle add up; one for a different rectangle, or that moves
+   everything out of view, cancels the hint. It's only an optimization,
+   so losing one costs nothing but redrawing. */
+
+void PDC_scroll_hint(int top, int left, int bottom, int right,
+                     int dy, int dx)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+
+    if (!PDC_move_rect || o->headless)
+        return;
+
+    if (o->scroll_hint)
+    {
+        o->scroll_hint = FALSE;
+
+        if (top != o->scroll_top || left != o->scroll_left ||
+            bottom != o->scroll_bottom || right != o->scroll_right)
+            return;
+
+        dy += o->scroll_dy;
+        dx += o->scroll_dx;
+    }
+
+    if ((!dy && !dx) || abs(dy) > bottom - top || abs(dx) > right - left)
+        return;
+
+    o->scroll_hint = TRUE;
+    o->scroll_top = top;
+    o->scroll_left = left;
+    o->scroll_bottom = bottom;
+    o->scroll_right = right;
+    o->scroll_dy = dy;
+    o->scroll_dx = dx;
+}
+
+/* Act on the scroll hint: have the port move what's on the screen, and
+   move the same cells of SP->lastscr to match. Cells uncovered by the
+   move keep what they showed. The rectangle is then marked as changed
+   in curscr, so that whatever still differs is drawn as usual. */
+
+static void _apply_scroll(void)
+{
+    struct _opaque_screen_t *o = SP->opaque;
+    int top = o->scroll_top, bottom = o->scroll_bottom;
+    int left = o->scroll_left, right = o->scroll_right;
+    int dy = o->scroll_dy, dx = o->scroll_dx;
+    int to = (dx < 0) ? left - dx : left;
+    int width = right - left + 1 - abs(dx);
+    int y, step = (dy < 0) ? -1 : 1;
+
+    if (bottom >= SP->lines || right >= SP->cols ||
+        PDC_move_rect(top, left, bottom, right, dy, dx) == ERR)
+        return;
+
+    if (o->record)
+        PDC_record_move(top, left, bottom, right, dy, dx);
+
+    /* copy in the direction that doesn't overwrite rows still to be
+       read */
+
+    for (y = (dy < 0) ? bottom : top; y + dy >= top && y + dy <= bottom;
+         y += step)
+    {
+        chtype *dest = SP->lastscr->_y[y];
+        const chtype *src = SP->lastscr->_y[y + dy] + dx;
+
+        _update_blink(y, to, width, src, dest);
+        memmove(dest + to, src + to, width * sizeof(chtype));
+    }
+
+    for (y = top; y <= bottom; y++)
+        PDC_touch_span(curscr, y, left, right);
+}
+
+/* Find the columns of row y covered by the mouse selection, which
+   doupdate() shows in reverse video on top of curscr */
+
+static bool _selected_cols(int y, int *from, int *to)
+{
+    int start = SP->sel_start, end = SP->sel_end;
+
+    if (-1 == start)
+        return FALSE;
+
+    if (start > end)
+    {
+        start = SP->sel_end;
+        end = SP->sel_start;
+    }
+
+    if (y < start / COLS || y > end / COLS)
+        return FALSE;
+
+    *from = (y == start / COLS) ? start % COLS : 0;
+    *to = (y == end / COLS) ? end % COLS : COLS;
+
+    return *from < *to;
+}
+
 int wnoutrefresh(WINDOW *win)
 {
     int begy, begx;     /* window's place on screen   */
@@ -72,15 +531,15 @@ int wnoutrefresh(WINDOW *win)
 
     for (i = 0, j = begy; i < win->_maxy; i++, j++)
     {
-        if (win->_firstch[i] != _NO_CHANGE)
-        {
-            chtype *src = win->_y[i];
-            chtype *dest = curscr->_y[j] + begx;
+        chtype *src = win->_y[i];
+        chtype *dest = curscr->_y[j] + begx;
+        int x, end;
 
-            int first = win->_firstch[i]; /* first changed */
-            int last = win->_lastch[i];   /* last changed */
+        for (x = 0; PDC_next_change(win, i, &x, &end); x = end + 1)
+        {
+            int first = x, last = end;
 
-            /* ignore areas on the outside that are marked as changed,
+            /* ignore cells at either end that are marked as changed,
                but really aren't */
 
             while (first <= last && src[first] == dest[first])
@@ -96,21 +555,11 @@ int wnoutrefresh(WINDOW *win)
                 memcpy(dest + first, src + first,
                        (last - first + 1) * sizeof(chtype));
 
-                first += begx;
-                last += begx;
-
-                if (first < curscr->_firstch[j] ||
-                    curscr->_firstch[j] == _NO_CHANGE)
-                    curscr->_firstch[j] = first;
-
-                if (last > curscr->_lastch[j])
-                    curscr->_lastch[j] = last;
+                PDC_touch_span(curscr, j, first + begx, last + begx);
             }
-
-            win->_firstch[i] = _NO_CHANGE;  /* updated now */
         }
 
-        win->_lastch[i] = _NO_CHANGE;       /* updated now */
+        PDC_untouch_line(win, i);       /* updated now */
     }
 
     if (win->_clear)
@@ -125,15 +574,24 @@ int wnoutrefresh(WINDOW *win)
     return OK;
 }
 
-int doupdate(void)
+/* The next run of cells in row y to compare, starting from *from: if
+   whole, the rest of the row up to last; otherwise, the next run that
+   curscr has marked as changed */
+
+static bool _next_run(int y, bool whole, int *from, int *to, int last)
 {
-    int y;
-    bool clearall;
+    if (!whole)
+        return PDC_next_change(curscr, y, from, to);
 
-    PDC_LOG(("doupdate() - called\n"));
+    *to = last;
 
-    if (!SP || !curscr)
-        return ERR;
+    return *from <= last;
+}
+
+static int _update(void)
+{
+    int y, count = 0;
+    bool clearall;
 
     if (isendwin())         /* coming back after endwin() called */
     {
@@ -144,15 +602,28 @@ int doupdate(void)
     else
         clearall = curscr->_clear;
 
+    if (SP->opaque->scroll_hint)
+    {
+        SP->opaque->scroll_hint = FALSE;
+
+        if (!clearall)
+            _apply_scroll();
+    }
+
     for (y = 0; y < SP->lines; y++)
     {
+        int stale_first, stale_last;
+        bool stale = !clearall && SP->opaque->stale_pairs &&
+                     _stale_span(y, &stale_first, &stale_last);
+
         PDC_LOG(("doupdate() - Transforming line %d of %d: %s\n",
                  y, SP->lines, (curscr->_firstch[y] != _NO_CHANGE) ?
                  "Yes" : "No"));
 
-        if (clearall || curscr->_firstch[y] != _NO_CHANGE)
+        if (clearall || stale || curscr->_firstch[y] != _NO_CHANGE)
         {
-            int first, last;
+            int first, last, from, to, sel_from, sel_to;
+            bool sel;
 
             chtype *src = curscr->_y[y];
             chtype *dest = SP->lastscr->_y[y];
@@ -166,60 +637,210 @@ int doupdate(void)
             {
                 first = curscr->_firstch[y];
                 last = curscr->_lastch[y];
+
+                if (stale)
+                {
+                    if (first == _NO_CHANGE || stale_first < first)
+                        first = stale_first;
+                    if (stale_last > last)
+                        last = stale_last;
+                }
             }
 
-            while (first <= last)
+            /* apply the selection highlight in place for the duration
+               of the update, so that SP->lastscr records what's
+               actually shown */
+
+            sel = _selected_cols(y, &sel_from, &sel_to);
+            if (sel)
             {
-                int len = 0;
-
-                /* build up a run of changed cells; if two runs are
-                   separated by a single unchanged cell, ignore the
-                   break */
-
-                if (clearall)
-                    len = last - first + 1;
-                else
-                    while (first + len <= last &&
-                           (src[first + len] != dest[first + len] ||
-                            (len && first + len < last &&
-                             src[first + len + 1] != dest[first + len + 1])
-                           )
-                          )
-                        len++;
-
-                /* update the screen, and SP->lastscr */
-
-                if (len)
+                int x;
+
+                if (sel_from < first)
+                    sel_from = first;
+                if (sel_to > last + 1)
+                    sel_to = last + 1;
+
+                for (x = sel_from; x < sel_to; x++)
+                    src[x] ^= A_REVERSE;
+            }
+
+            if (stale)
+                _unmatch_stale(src, dest, stale_first, stale_last);
+
+            for (from = first; _next_run(y, clearall || stale, &from, &to,
+                                         last); from = to + 1)
+            {
+                while (from <= to)
                 {
-                    PDC_transform_line(y, first, len, src + first);
-                    memcpy(dest + first, src + first, len * sizeof(chtype));
-                    first += len;
+                    int len = 0;
+
+                    /* build up a run of changed cells; if two runs are
+                       separated by a single unchanged cell, ignore the
+                       break */
+
+                    if (clearall)
+                        len = to - from + 1;
+                    else
+                        while (from + len <= to &&
+                               (src[from + len] != dest[from + len] ||
+                                (len && from + len < to &&
+                                 src[from + len + 1] != dest[from + len + 1])
+                               )
+                              )
+                            len++;
+
+                    /* update the screen, and SP->lastscr */
+
+                    /* the port is given SP->lastscr's copy, which stays
+                       put until the next update */
+
+                    if (len)
+                    {
+                        _update_blink(y, from, len, src, dest);
+                        memcpy(dest + from, src + from,
+                               len * sizeof(chtype));
+                        _draw(&count, y, from, len, dest + from);
+                        from += len;
+                    }
+
+                    /* skip over runs of unchanged cells */
+
+                    while (from <= to && src[from] == dest[from])
+                        from++;
                 }
+            }
 
-                /* skip over runs of unchanged cells */
+            if (sel)
+            {
+                int x;
 
-                while (first <= last && src[first] == dest[first])
-                    first++;
+                for (x = sel_from; x < sel_to; x++)
+                    src[x] ^= A_REVERSE;
             }
 
-            curscr->_firstch[y] = _NO_CHANGE;
-            curscr->_lastch[y] = _NO_CHANGE;
+            if (SP->opaque->mirror)
+                PDC_mirror_mark(y, first, last);
+
+            PDC_untouch_line(curscr, y);
         }
     }
 
+    if (count)
+        PDC_transform_frame(SP->opaque->spans, count);
+
+    /* all cells using changed pairs have now been redrawn */
+
+    if (SP->opaque->stale_pairs)
+    {
+        memset(SP->opaque->pair_stale, 0,
+               PDC_PAIR_WORDS * sizeof(unsigned long));
+        SP->opaque->stale_pairs = FALSE;
+    }
+
     curscr->_clear = FALSE;
 
-    if (SP->visibility)
+    if (SP->visibility && !SP->opaque->headless)
         PDC_gotoyx(curscr->_cury, curscr->_curx);
 
     SP->cursrow = curscr->_cury;
     SP->curscol = curscr->_curx;
 
-    PDC_doupdate();
+    if (SP->opaque->mirror)
+        PDC_mirror_publish();
+
+    if (SP->opaque->record)
+        PDC_record_frame();
+
+    if (!SP->opaque->headless)
+        PDC_doupdate();
+
+    SP->opaque->frame_deferred = FALSE;
+    if (SP->opaque->frame_ms)
+        SP->opaque->frame_time = PDC_ms_count();
 
     return OK;
 }
 
+int doupdate(void)
+{
+    PDC_LOG(("doupdate() - called\n"));
+
+    if (!SP || !curscr)
+        return ERR;
+
+    /* too soon after the last update -- leave the changes marked in
+       curscr, for PDC_frame_due() to pick up */
+
+    if (SP->opaque->frame_ms && !isendwin() &&
+        PDC_ms_count() - SP->opaque->frame_time <
+        (unsigned long)SP->opaque->frame_ms)
+    {
+        SP->opaque->frame_deferred = TRUE;
+        return OK;
+    }
+
+    return _update();
+}
+
+int PDC_flush_frame(void)
+{
+    PDC_LOG(("PDC_flush_frame() - called\n"));
+
+    if (!SP || !curscr)
+        return ERR;
+
+    return _update();
+}
+
+int PDC_set_frame_rate(int fps)
+{
+    PDC_LOG(("PDC_set_frame_rate() - called: fps %d\n", fps));
+
+    if (!SP || fps < 0)
+        return ERR;
+
+    if (!fps)
+    {
+        SP->opaque->frame_ms = 0;
+
+        if (SP->opaque->frame_deferred)
+            PDC_flush_frame();
+    }
+    else
+    {
+        SP->opaque->frame_ms = (1000 + fps - 1) / fps;
+
+        /* let the next update through at once */
+
+        SP->opaque->frame_time = PDC_ms_count() -
+                                 SP->opaque->frame_ms;
+    }
+
+    return OK;
+}
+
+/* Send out a deferred update if its interval has passed. Returns the
+   number of milliseconds until it will be due, or 0 if nothing is
+   waiting. */
+
+int PDC_frame_due(void)
+{
+    unsigned long elapsed;
+
+    if (!SP || !SP->opaque->frame_deferred)
+        return 0;
+
+    elapsed = PDC_ms_count() - SP->opaque->frame_time;
+
+    if (elapsed < (unsigned long)SP->opaque->frame_ms)
+        return SP->opaque->frame_ms - (int)elapsed;
+
+    PDC_flush_frame();
+
+    return 0;
+}
+
 int wrefresh(WINDOW *win)
 {
     bool save_clear;
@@ -260,10 +881,7 @@ int wredrawln(WINDOW *win, int start, int num)
         return ERR;
 
     for (i = start; i < start + num; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
-    }
+        PDC_touch_span(win, i, 0, win->_maxx - 1);
 
     return OK;
 }
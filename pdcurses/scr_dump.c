@@ -24,7 +24,7 @@ scr_dump
 
    putwin() writes all data associated with a window into a file, using
    an unspecified format. This information can be retrieved later using
-   getwin().
+   getwin(). A virtual pad can't be written this way.
 
    scr_dump() writes the current contents of the virtual screen to the
    file named by filename in an unspecified format.
@@ -60,7 +60,7 @@ scr_dump
 #include <stdlib.h>
 #include <string.h>
 
-#define DUMPVER 1   /* Should be updated whenever the WINDOW struct is
+#define DUMPVER 5   /* Should be updated whenever the WINDOW struct is
                        changed */
 
 int putwin(WINDOW *win, FILE *filep)
@@ -70,6 +70,9 @@ int putwin(WINDOW *win, FILE *filep)
 
     PDC_LOG(("putwin() - called\n"));
 
+    if (!win || win->_vpad)
+        return ERR;
+
     /* write the marker and the WINDOW struct */
 
     if (filep && fwrite(marker, strlen(marker), 1, filep)
@@ -142,6 +145,18 @@ WINDOW *getwin(FILE *filep)
         return (WINDOW *)NULL;
     }
 
+    win->_dirty = NULL;
+    win->_vpad = NULL;
+
+    if (PDC_makedirty(win, nlines, ncols) == ERR)
+    {
+        free(win->_lastch);
+        free(win->_firstch);
+        free(win->_y);
+        free(win);
+        return (WINDOW *)NULL;
+    }
+
     /* allocate the lines */
 
     win = PDC_makelines(win);
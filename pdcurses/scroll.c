@@ -38,49 +38,69 @@ scroll
 
 **man-end****************************************************************/
 
-int wscrl(WINDOW *win, int n)
+#include <stdlib.h>
+
+static void _reverse(chtype **line, int first, int last)
 {
-    int i, l, dir, start, end;
-    chtype blank, *temp;
+    while (first < last)
+    {
+        chtype *temp = line[first];
 
-    /* Check if window scrolls. Valid for window AND pad */
+        line[first++] = line[last];
+        line[last--] = temp;
+    }
+}
 
-    if (!win || !win->_scroll || !n)
-        return ERR;
+/* Move lines top through bottom of win up n lines, or down -n lines,
+   blanking those left uncovered. The line pointers are rotated once,
+   however far the move, and all the lines are marked as changed. Unless
+   win is a pad, doupdate() is told how they moved, in case the screen
+   can scroll what's already displayed. */
 
-    blank = win->_bkgd;
+void PDC_scroll_lines(WINDOW *win, int top, int bottom, int n)
+{
+    int height = bottom - top + 1;
+    int first = top, last = bottom;
+    chtype blank = win->_bkgd;
 
-    if (n > 0)
+    if (abs(n) < height)
     {
-        start = win->_tmarg;
-        end = win->_bmarg;
-        dir = 1;
-    }
-    else
-    {
-        start = win->_bmarg;
-        end = win->_tmarg;
-        dir = -1;
+        int k = (n > 0) ? n : height + n;
+
+        _reverse(win->_y, top, top + k - 1);
+        _reverse(win->_y, top + k, bottom);
+        _reverse(win->_y, top, bottom);
+
+        if (n > 0)
+            first = bottom - n + 1;
+        else
+            last = top - n - 1;
+
+        if (!(win->_flags & (_PAD|_SUBPAD)) && win != curscr)
+            PDC_scroll_hint(win->_begy + top, win->_begx,
+                            win->_begy + bottom,
+                            win->_begx + win->_maxx - 1, n, 0);
     }
 
-    for (l = 0; l < (n * dir); l++)
+    for (; first <= last; first++)
     {
-        temp = win->_y[start];
-
-        /* re-arrange line pointers */
+        chtype *ptr = win->_y[first], *end = ptr + win->_maxx;
 
-        for (i = start; i != end; i += dir)
-            win->_y[i] = win->_y[i + dir];
+        while (ptr < end)
+            *ptr++ = blank;
+    }
 
-        win->_y[end] = temp;
+    touchline(win, top, height);
+}
 
-        /* make a blank line */
+int wscrl(WINDOW *win, int n)
+{
+    /* Check if window scrolls. Valid for window AND pad */
 
-        for (i = 0; i < win->_maxx; i++)
-            *temp++ = blank;
-    }
+    if (!win || !win->_scroll || !n)
+        return ERR;
 
-    touchline(win, win->_tmarg, win->_bmarg - win->_tmarg + 1);
+    PDC_scroll_lines(win, win->_tmarg, win->_bmarg, n);
 
     PDC_sync(win);
     return OK;
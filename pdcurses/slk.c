@@ -38,7 +38,8 @@ slk
    These functions manipulate a window that contain Soft Label Keys
    (SLK). To use the SLK functions, a call to slk_init() must be made
    BEFORE initscr() or newterm(). slk_init() removes 1 or 2 lines from
-   the useable screen, depending on the format selected.
+   the useable screen, depending on the format selected. It applies only
+   to the next screen created; each screen has its own labels.
 
    The line(s) removed from the screen are used as a separate window, in
    which SLKs are displayed.
@@ -88,21 +89,29 @@ slk
 
 enum { LABEL_NORMAL = 8, LABEL_EXTENDED = 10, LABEL_NCURSES_EXTENDED = 12 };
 
-static int label_length = 0;
-static int labels = 0;
-static int label_fmt = 0;
-static int label_line = 0;
-static bool hidden = FALSE;
+/* set by slk_init(), and taken up by the next screen created */
 
-static struct SLK {
+static int pending_labels = 0;
+static int pending_fmt = 0;
+
+/* the labels themselves belong to the current screen */
+
+#define slk          (SP->opaque->slk)
+#define labels       (SP->opaque->slk_labels)
+#define label_length (SP->opaque->slk_length)
+#define label_fmt    (SP->opaque->slk_fmt)
+#define label_line   (SP->opaque->slk_line)
+#define hidden       (SP->opaque->slk_hidden)
+
+struct SLK {
     chtype label[32];
     int len;
     int format;
     int start_col;
-} *slk = (struct SLK *)NULL;
+};
 
 /* slk_init() is the slk initialization routine.
-   This must be called before initscr().
+   This must be called before initscr() or newterm().
 
    label_fmt = 0, 1 or 55.
        0 = 3-2-3 format
@@ -116,43 +125,35 @@ int slk_init(int fmt)
 {
     PDC_LOG(("slk_init() - called\n"));
 
-    if (SP)
-        return ERR;
-
     switch (fmt)
     {
     case 0:  /* 3 - 2 - 3 */
-        labels = LABEL_NORMAL;
+        pending_labels = LABEL_NORMAL;
         break;
 
     case 1:   /* 4 - 4 */
-        labels = LABEL_NORMAL;
+        pending_labels = LABEL_NORMAL;
         break;
 
     case 2:   /* 4 4 4 */
-        labels = LABEL_NCURSES_EXTENDED;
+        pending_labels = LABEL_NCURSES_EXTENDED;
         break;
 
     case 3:   /* 4 4 4  with index */
-        labels = LABEL_NCURSES_EXTENDED;
+        pending_labels = LABEL_NCURSES_EXTENDED;
         break;
 
     case 55:  /* 5 - 5 */
-        labels = LABEL_EXTENDED;
+        pending_labels = LABEL_EXTENDED;
         break;
 
     default:
         return ERR;
     }
 
-    label_fmt = fmt;
-
-    slk = calloc(labels, sizeof(struct SLK));
+    pending_fmt = fmt;
 
-    if (!slk)
-        labels = 0;
-
-    return slk ? OK : ERR;
+    return OK;
 }
 
 /* draw a single button */
@@ -216,7 +217,8 @@ int slk_set(int labnum, const char *label, int justify)
 #else
     PDC_LOG(("slk_set() - called\n"));
 
-    if (labnum < 1 || labnum > labels || justify < 0 || justify > 2)
+    if (!SP || labnum < 1 || labnum > labels || justify < 0 ||
+        justify > 2)
         return ERR;
 
     labnum--;
@@ -296,7 +298,7 @@ char *slk_label(int labnum)
 
     PDC_LOG(("slk_label() - called\n"));
 
-    if (labnum < 1 || labnum > labels)
+    if (!SP || labnum < 1 || labnum > labels)
         return (char *)0;
 
     for (i = 0, p = slk[labnum - 1].label; *p; i++)
@@ -512,6 +514,17 @@ static void _slk_calc(void)
 
 void PDC_slk_initialize(void)
 {
+    if (!slk && pending_labels)
+    {
+        slk = calloc(pending_labels, sizeof(struct SLK));
+        if (!slk)
+            return;
+
+        labels = pending_labels;
+        label_fmt = pending_fmt;
+        pending_labels = 0;
+    }
+
     if (slk)
     {
         if (label_fmt == 3)
@@ -601,7 +614,8 @@ int slk_wset(int labnum, const wchar_t *label, int justify)
 {
     PDC_LOG(("slk_wset() - called\n"));
 
-    if (labnum < 1 || labnum > labels || justify < 0 || justify > 2)
+    if (!SP || labnum < 1 || labnum > labels || justify < 0 ||
+        justify > 2)
         return ERR;
 
     labnum--;
@@ -658,7 +672,7 @@ wchar_t *slk_wlabel(int labnum)
 
     PDC_LOG(("slk_wlabel() - called\n"));
 
-    if (labnum < 1 || labnum > labels)
+    if (!SP || labnum < 1 || labnum > labels)
         return (wchar_t *)0;
 
     for (i = 0, p = slk[labnum - 1].label; *p; i++)
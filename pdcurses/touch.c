@@ -60,6 +60,103 @@ touch
 
 **man-end****************************************************************/
 
+#include <string.h>
+
+/* A window's changes are recorded two ways: _firstch and _lastch give
+   the first and last changed cell of each line, and the _dirty bitmap
+   has a bit set for each chunk of PDC_CHUNK cells in which something
+   changed. The bounds are what the rest of the library (and the
+   application) may look at; the bitmap lets refreshes skip the
+   unchanged stretches in between. _touched counts the lines whose
+   _firstch is set, so that is_wintouched() needn't look at them all,
+   and _gen goes up with each change. Every change is marked through
+   PDC_touch_span(), and cleared through PDC_untouch_line(), so the
+   bitmap is always complete: a cell that isn't in a marked chunk is
+   never redrawn, whatever the bounds say. */
+
+#define _CHUNK_SET(map, c) \
+    ((map)[(c) / PDC_BLINK_BITS] & (1UL << ((c) % PDC_BLINK_BITS)))
+
+/* Mark cells first through last of line y as changed */
+
+void PDC_touch_span(WINDOW *win, int y, int first, int last)
+{
+    unsigned long *map = PDC_DIRTY(win, y);
+    int c;
+
+    if (win->_firstch[y] == _NO_CHANGE)
+    {
+        win->_firstch[y] = first;
+        win->_touched++;
+    }
+    else if (first < win->_firstch[y])
+        win->_firstch[y] = first;
+
+    if (last > win->_lastch[y])
+        win->_lastch[y] = last;
+
+    for (c = first / PDC_CHUNK; c <= last / PDC_CHUNK; c++)
+        map[c / PDC_BLINK_BITS] |= 1UL << (c % PDC_BLINK_BITS);
+
+    win->_gen++;
+}
+
+/* Mark line y as unchanged */
+
+void PDC_untouch_line(WINDOW *win, int y)
+{
+    if (win->_firstch[y] != _NO_CHANGE)
+    {
+        memset(PDC_DIRTY(win, y), 0, win->_dwords * sizeof(unsigned long));
+        win->_touched--;
+    }
+
+    win->_firstch[y] = _NO_CHANGE;
+    win->_lastch[y] = _NO_CHANGE;
+}
+
+/* Find the next run of changed cells in line y, at or after column
+   *first, and return it in *first and *last; or return FALSE if there
+   are no more. Runs are whole chunks, trimmed to the line's bounds. */
+
+bool PDC_next_change(const WINDOW *win, int y, int *first, int *last)
+{
+    const unsigned long *map = PDC_DIRTY(win, y);
+    int from = max(*first, win->_firstch[y]);
+    int to = win->_lastch[y];
+    int c, end, stop;
+
+    if (win->_firstch[y] == _NO_CHANGE || from > to)
+        return FALSE;
+
+    c = from / PDC_CHUNK;
+    stop = to / PDC_CHUNK;
+
+    while (c <= stop && !(map[c / PDC_BLINK_BITS] >> (c % PDC_BLINK_BITS)))
+        c = (c / PDC_BLINK_BITS + 1) * PDC_BLINK_BITS;
+
+    while (c <= stop && !_CHUNK_SET(map, c))
+        c++;
+
+    if (c > stop)
+        return FALSE;
+
+    for (end = c; end < stop && _CHUNK_SET(map, end + 1); end++)
+        ;
+
+    *first = max(from, c * PDC_CHUNK);
+    *last = min(to, end * PDC_CHUNK + PDC_CHUNK - 1);
+
+    return TRUE;
+}
+
+/* Mark all of line y as changed */
+
+static void _touch_line(WINDOW *win, int y)
+{
+    PDC_touch_span(win, y, 0, win->_maxx - 1);
+}
+
 int touchwin(WINDOW *win)
 {
     int i;
@@ -69,10 +166,15 @@ int touchwin(WINDOW *win)
     if (!win)
         return ERR;
 
+    /* this also serves to set up the bounds of a new window, so what's
+       there already doesn't count */
+
+    win->_touched = 0;
+
     for (i = 0; i < win->_maxy; i++)
     {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
+        win->_firstch[i] = win->_lastch[i] = _NO_CHANGE;
+        _touch_line(win, i);
     }
 
     return OK;
@@ -89,10 +191,7 @@ int touchline(WINDOW *win, int start, int count)
         return ERR;
 
     for (i = start; i < start + count; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
-    }
+        _touch_line(win, i);
 
     return OK;
 }
@@ -107,10 +206,7 @@ int untouchwin(WINDOW *win)
         return ERR;
 
     for (i = 0; i < win->_maxy; i++)
-    {
-        win->_firstch[i] = _NO_CHANGE;
-        win->_lastch[i] = _NO_CHANGE;
-    }
+        PDC_untouch_line(win, i);
 
     return OK;
 }
@@ -128,15 +224,9 @@ int wtouchln(WINDOW *win, int y, int n, int changed)
     for (i = y; i < y + n; i++)
     {
         if (changed)
-        {
-            win->_firstch[i] = 0;
-            win->_lastch[i] = win->_maxx - 1;
-        }
+            _touch_line(win, i);
         else
-        {
-            win->_firstch[i] = _NO_CHANGE;
-            win->_lastch[i] = _NO_CHANGE;
-        }
+            PDC_untouch_line(win, i);
     }
 
     return OK;
@@ -154,16 +244,9 @@ bool is_linetouched(WINDOW *win, int line)
 
 bool is_wintouched(WINDOW *win)
 {
-    int i;
-
     PDC_LOG(("is_wintouched() - called: win=%p\n", win));
 
-    if (win)
-        for (i = 0; i < win->_maxy; i++)
-            if (win->_firstch[i] != _NO_CHANGE)
-                return TRUE;
-
-    return FALSE;
+    return (win && win->_touched) ? TRUE : FALSE;
 }
 
 int touchoverlap(const WINDOW *win1, WINDOW *win2)
@@ -190,10 +273,7 @@ int touchoverlap(const WINDOW *win1, WINDOW *win2)
     endx -= 1;
 
     for (y = starty; y < endy; y++)
-    {
-        win2->_firstch[y] = startx;
-        win2->_lastch[y] = endx;
-    }
+        PDC_touch_span(win2, y, startx, endx);
 
     return OK;
 }
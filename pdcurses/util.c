@@ -39,11 +39,13 @@ util
    cchar_t pointed to by wcval and stores the attributes in attrs, the
    color pair in color_pair, and the text in the wide-character string
    wch. When wch is NULL, getcchar() merely returns the number of wide
-   characters in wcval. In either mode, the opts argument is unused.
+   characters in wcval. If opts is not NULL, getcchar() also stores the
+   color pair in the int it points to.
 
    setcchar constructs a cchar_t at wcval from the wide-character text
-   at wch, the attributes in attr and the color pair in color_pair. The
-   opts argument is unused.
+   at wch, the attributes in attr and the color pair in color_pair, or
+   in the int pointed to by opts, if that's not NULL. The int versions
+   can hold pairs above 32767.
 
    Currently, the length returned by getcchar() is always 1 or 0.
    Similarly, setcchar() will only take the first wide character from
@@ -138,6 +140,9 @@ int getcchar(const cchar_t *wcval, wchar_t *wch, attr_t *attrs,
         *attrs = (*wcval & (A_ATTRIBUTES & ~A_COLOR));
         *color_pair = PAIR_NUMBER(*wcval & A_COLOR);
 
+        if (opts)
+            *(int *)opts = PAIR_NUMBER(*wcval & A_COLOR);
+
         if (*wch)
             *++wch = L'\0';
 
@@ -153,7 +158,8 @@ int setcchar(cchar_t *wcval, const wchar_t *wch, const attr_t attrs,
     if (!wcval || !wch)
         return ERR;
 
-    *wcval = *wch | attrs | COLOR_PAIR(color_pair);
+    *wcval = *wch | attrs | COLOR_PAIR(opts ? *(const int *)opts :
+                                       color_pair);
 
     return OK;
 }
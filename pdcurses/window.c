@@ -62,9 +62,11 @@ window
    This routine is used to display different parts of the parent window
    at the same physical position on the screen.
 
-   dupwin() creates an exact duplicate of the window win.
+   dupwin() creates an exact duplicate of the window win. It can't
+   duplicate a virtual pad (see newvpad()).
 
-   wsyncup() causes a touchwin() of all of the window's parents.
+   wsyncup() marks as changed, in each of the window's ancestors, the
+   cells that are marked as changed in the window itself.
 
    If wsyncok() is called with a second argument of TRUE, this causes a
    wsyncup() to be called every time the window is changed.
@@ -73,17 +75,24 @@ window
    ancestors to reflect the current cursor position of the current
    window.
 
-   wsyncdown() causes a touchwin() of the current window if any of its
-   parent's windows have been touched.
+   wsyncdown() marks as changed the cells of the current window that
+   are marked as changed in any of its ancestors.
 
    resize_window() allows the user to resize an existing window. It
    returns the pointer to the new window, or NULL on failure.
 
+   A virtual pad can't be resized this way; use vpad_resize().
+
    wresize() is an ncurses-compatible wrapper for resize_window(). Note
    that, unlike ncurses, it will NOT process any subwindows of the
    window. (However, you still can call it _on_ subwindows.) It returns
    OK or ERR.
 
+   A window that owns its lines is resized in place. Its line storage
+   only grows, with some headroom, so that a run of resizes -- as when
+   the terminal window is dragged -- mostly reuses what's already
+   allocated.
+
    PDC_makenew() allocates all data for a new WINDOW * except the actual
    lines themselves. If it's unable to allocate memory for the window
    structure, it will free all allocated memory and return a NULL
@@ -132,6 +141,27 @@ window
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+
+/* (Re)allocate the bitmap of changed chunks for nlines by ncols, all
+   clear; see touch.c. There's a spare word, so it's never empty. */
+
+int PDC_makedirty(WINDOW *win, int nlines, int ncols)
+{
+    int words = PDC_DIRTY_WORDS(ncols);
+    size_t size = (nlines * words + 1) * sizeof(unsigned long);
+    unsigned long *dirty = realloc(win->_dirty, size);
+
+    if (!dirty)
+        return ERR;
+
+    memset(dirty, 0, size);
+
+    win->_dirty = dirty;
+    win->_dwords = words;
+
+    return OK;
+}
 
 WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
 {
@@ -174,6 +204,15 @@ WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
         return (WINDOW *)NULL;
     }
 
+    if (PDC_makedirty(win, nlines, ncols) == ERR)
+    {
+        free(win->_lastch);
+        free(win->_firstch);
+        free(win->_y);
+        free(win);
+        return (WINDOW *)NULL;
+    }
+
     /* initialize window variables */
 
     win->_maxy = nlines;  /* real max screen size */
@@ -204,6 +243,9 @@ WINDOW *PDC_makelines(WINDOW *win)
     nlines = win->_maxy;
     ncols = win->_maxx;
 
+    win->_ycap = nlines;
+    win->_xcap = ncols;
+
     for (i = 0; i < nlines; i++)
     {
         win->_y[i] = malloc(ncols * sizeof(chtype));
@@ -216,6 +258,7 @@ WINDOW *PDC_makelines(WINDOW *win)
 
             free(win->_firstch);
             free(win->_lastch);
+            free(win->_dirty);
             free(win->_y);
             free(win);
 
@@ -273,12 +316,16 @@ int delwin(WINDOW *win)
     /* subwindows use parents' lines */
 
     if (!(win->_flags & (_SUBWIN|_SUBPAD)))
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
+        for (i = 0; i < win->_ycap; i++)
             if (win->_y[i])
                 free(win->_y[i]);
 
+    if (win->_vpad)
+        PDC_vpad_free(win);
+
     free(win->_firstch);
     free(win->_lastch);
+    free(win->_dirty);
     free(win->_y);
     free(win);
 
@@ -386,7 +433,7 @@ WINDOW *dupwin(WINDOW *win)
     chtype *ptr, *ptr1;
     int nlines, ncols, begy, begx, i;
 
-    if (!win)
+    if (!win || win->_vpad)
         return (WINDOW *)NULL;
 
     nlines = win->_maxy;
@@ -404,15 +451,10 @@ WINDOW *dupwin(WINDOW *win)
     /* copy the contents of win into new */
 
     for (i = 0; i < nlines; i++)
-    {
         for (ptr = new->_y[i], ptr1 = win->_y[i];
              ptr < new->_y[i] + ncols; ptr++, ptr1++)
             *ptr = *ptr1;
 
-        new->_firstch[i] = 0;
-        new->_lastch[i] = ncols - 1;
-    }
-
     new->_curx = win->_curx;
     new->_cury = win->_cury;
     new->_maxy = win->_maxy;
@@ -438,15 +480,85 @@ WINDOW *dupwin(WINDOW *win)
     return new;
 }
 
+/* Make room in a window's own storage for nlines by ncols, growing by
+   at least half again when it's too small. Lines past the window's
+   bottom are kept for reuse. Newly exposed cells are blanked. */
+
+static int _resize_lines(WINDOW *win, int nlines, int ncols)
+{
+    int i, x;
+
+    if (nlines > win->_ycap)
+    {
+        int cap = max(nlines, win->_ycap + win->_ycap / 2);
+        chtype **y;
+        int *first, *last;
+
+        y = realloc(win->_y, cap * sizeof(chtype *));
+        if (!y)
+            return ERR;
+
+        win->_y = y;
+
+        for (i = win->_ycap; i < cap; i++)
+            win->_y[i] = NULL;
+
+        first = realloc(win->_firstch, cap * sizeof(int));
+        if (!first)
+            return ERR;
+
+        win->_firstch = first;
+
+        last = realloc(win->_lastch, cap * sizeof(int));
+        if (!last)
+            return ERR;
+
+        win->_lastch = last;
+        win->_ycap = cap;
+    }
+
+    if (ncols > win->_xcap)
+    {
+        int cap = max(ncols, win->_xcap + win->_xcap / 2);
+
+        for (i = 0; i < win->_ycap; i++)
+            if (win->_y[i])
+            {
+                chtype *line = realloc(win->_y[i], cap * sizeof(chtype));
+                if (!line)
+                    return ERR;
+
+                win->_y[i] = line;
+            }
+
+        win->_xcap = cap;
+    }
+
+    for (i = 0; i < nlines; i++)
+    {
+        if (!win->_y[i])
+        {
+            win->_y[i] = malloc(win->_xcap * sizeof(chtype));
+            if (!win->_y[i])
+                return ERR;
+        }
+
+        for (x = (i < win->_maxy) ? win->_maxx : 0; x < ncols; x++)
+            win->_y[i][x] = ' ';
+    }
+
+    return OK;
+}
+
 WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 {
     WINDOW *new;
-    int i, save_cury, save_curx, new_begy, new_begx;
+    int save_cury, save_curx;
 
     PDC_LOG(("resize_window() - called: nlines %d ncols %d\n",
              nlines, ncols));
 
-    if (!win || !SP)
+    if (!win || !SP || win->_vpad)
         return (WINDOW *)NULL;
 
     if (win->_flags & _SUBPAD)
@@ -463,41 +575,33 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     }
     else
     {
+        if (_resize_lines(win, nlines, ncols) == ERR ||
+            PDC_makedirty(win, nlines, ncols) == ERR)
+            return (WINDOW *)NULL;
+
         if (win == SP->slk_winptr)
         {
-            new_begy = SP->lines - SP->slklines;
-            new_begx = 0;
-        }
-        else
-        {
-            new_begy = win->_begy;
-            new_begx = win->_begx;
+            win->_begy = SP->lines - SP->slklines;
+            win->_begx = 0;
         }
 
-        new = PDC_makenew(nlines, ncols, new_begy, new_begx);
-        if (!new)
-            return (WINDOW *)NULL;
-    }
+        win->_curx = min(win->_curx, ncols - 1);
+        win->_cury = min(win->_cury, nlines - 1);
+        win->_tmarg = (win->_tmarg > nlines - 1) ? 0 : win->_tmarg;
+        win->_bmarg = (win->_bmarg == win->_maxy - 1) ?
+                      nlines - 1 : min(win->_bmarg, nlines - 1);
 
-    save_curx = min(win->_curx, (new->_maxx - 1));
-    save_cury = min(win->_cury, (new->_maxy - 1));
+        win->_maxy = nlines;
+        win->_maxx = ncols;
 
-    if (!(win->_flags & (_SUBPAD|_SUBWIN)))
-    {
-        new = PDC_makelines(new);
-        if (!new)
-            return (WINDOW *)NULL;
+        touchwin(win);
 
-        werase(new);
-
-        copywin(win, new, 0, 0, 0, 0, min(win->_maxy, new->_maxy) - 1,
-                min(win->_maxx, new->_maxx) - 1, FALSE);
-
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (win->_y[i])
-                free(win->_y[i]);
+        return win;
     }
 
+    save_curx = min(win->_curx, (new->_maxx - 1));
+    save_cury = min(win->_cury, (new->_maxy - 1));
+
     new->_flags = win->_flags;
     new->_attrs = win->_attrs;
     new->_clear = win->_clear;
@@ -519,6 +623,7 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 
     free(win->_firstch);
     free(win->_lastch);
+    free(win->_dirty);
     free(win->_y);
 
     *win = *new;
@@ -535,11 +640,31 @@ int wresize(WINDOW *win, int nlines, int ncols)
 void wsyncup(WINDOW *win)
 {
     WINDOW *tmp;
+    int y, first, last, py, px;
 
     PDC_LOG(("wsyncup() - called\n"));
 
-    for (tmp = win; tmp; tmp = tmp->_parent)
-        touchwin(tmp);
+    if (!win)
+        return;
+
+    /* push each changed run up the chain, shifting it into the
+       coordinates of every ancestor in turn */
+
+    for (y = 0; y < win->_maxy; y++)
+        for (first = 0; PDC_next_change(win, y, &first, &last);
+             first = last + 1)
+        {
+            py = y;
+            px = 0;
+
+            for (tmp = win; tmp->_parent; tmp = tmp->_parent)
+            {
+                py += tmp->_pary;
+                px += tmp->_parx;
+
+                PDC_touch_span(tmp->_parent, py, first + px, last + px);
+            }
+        }
 }
 
 int syncok(WINDOW *win, bool bf)
@@ -567,15 +692,28 @@ void wcursyncup(WINDOW *win)
 void wsyncdown(WINDOW *win)
 {
     WINDOW *tmp;
+    int y, first, last, oy = 0, ox = 0;
 
     PDC_LOG(("wsyncdown() - called\n"));
 
-    for (tmp = win; tmp; tmp = tmp->_parent)
+    if (!win)
+        return;
+
+    /* oy, ox is where win sits inside each ancestor; only the part of
+       the ancestor's changes that falls over win is pulled down */
+
+    for (tmp = win; tmp->_parent; tmp = tmp->_parent)
     {
-        if (is_wintouched(tmp))
-        {
-            touchwin(win);
-            break;
-        }
+        WINDOW *anc = tmp->_parent;
+        int right;
+
+        oy += tmp->_pary;
+        ox += tmp->_parx;
+        right = ox + win->_maxx - 1;
+
+        for (y = 0; y < win->_maxy; y++)
+            for (first = ox; PDC_next_change(anc, oy + y, &first, &last) &&
+                 first <= right; first = last + 1)
+                PDC_touch_span(win, y, first - ox, min(last, right) - ox);
     }
 }
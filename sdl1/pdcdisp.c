@@ -17,29 +17,49 @@
 
 static SDL_Rect uprect[MAXRECT];       /* table of rects to update */
 static chtype oldch = (chtype)(-1);    /* current attribute */
+static PDC_PAIR *oldtab = NULL;        /* ...and its screen's pairs */
 static int rectcount = 0;              /* index into uprect */
+static bool span_rects = FALSE;        /* rects come from _draw_span(),
+                                          not from each packet */
+static bool update_all = FALSE;        /* flip the whole screen next */
 static short foregr = -2, backgr = -2; /* current foreground, background */
 static bool blinked_off = FALSE;
+static SDL_TimerID blinker_id = 0;     /* text blink timer */
+
+#ifndef PDC_WIDE
+# define MAXSHEET 32    /* maximum number of pre-colored font sheets to
+                           keep; each is a copy of the font */
+
+static struct
+{
+    SDL_Surface *sheet;
+    short fg, bg;
+    unsigned long used;
+} sheets[MAXSHEET];                    /* font sheets, by color pair */
+static unsigned long sheetclock = 0;   /* for least recently used */
+#endif
 
 /* do the real updates on a delay */
 
 void PDC_update_rects(void)
 {
-    if (rectcount)
+    if (rectcount || update_all)
     {
-        /* if the maximum number of rects has been reached, we're
-           probably better off doing a full screen update */
+        /* if most of the screen changed, or the maximum number of rects
+           has been reached, we're probably better off doing a full
+           screen update */
 
-        if (rectcount == MAXRECT)
+        if (update_all || rectcount == MAXRECT)
             SDL_Flip(pdc_screen);
         else
             SDL_UpdateRects(pdc_screen, rectcount, uprect);
 
         rectcount = 0;
+        update_all = FALSE;
     }
 }
 
-/* set the font colors to match the chtype's attribute */
+/* set the colors to match the chtype's attribute */
 
 static void _set_attr(chtype ch)
 {
@@ -55,14 +75,14 @@ static void _set_attr(chtype ch)
 
     ch &= (A_COLOR|A_BOLD|A_BLINK|A_REVERSE);
 
-    if (oldch != ch)
+    if (oldch != ch || oldtab != SP->atrtab)
     {
-        short newfg, newbg;
+        int newfg, newbg;
 
         if (SP->mono)
             return;
 
-        pair_content(PAIR_NUMBER(ch), &newfg, &newbg);
+        PDC_cell_colors(ch, &newfg, &newbg);
 
         if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
             newfg |= 8;
@@ -71,39 +91,117 @@ static void _set_attr(chtype ch)
 
         if (ch & A_REVERSE)
         {
-            short tmp = newfg;
+            int tmp = newfg;
             newfg = newbg;
             newbg = tmp;
         }
 
-        if (newfg != foregr)
-        {
+        foregr = newfg;
+        backgr = newbg;
+
+        oldch = ch;
+        oldtab = SP->atrtab;
+    }
+}
+
 #ifndef PDC_WIDE
-            SDL_SetPalette(pdc_font, SDL_LOGPAL,
-                           pdc_color + newfg, pdc_flastc, 1);
-#endif
-            foregr = newfg;
-        }
 
-        if (newbg != backgr)
+/* Build a copy of the font in the screen's pixel format, with glyphs
+   in color fg on bg. Where bg is -1, the background is transparent: it
+   gets a color unlike fg, which is made the color key. */
+
+static SDL_Surface *_make_sheet(short fg, short bg)
+{
+    SDL_Surface *sheet;
+    SDL_Color key;
+
+    if (bg == -1)
+    {
+        key.r = pdc_color[fg].r ^ 0x80;
+        key.g = pdc_color[fg].g ^ 0x80;
+        key.b = pdc_color[fg].b ^ 0x80;
+    }
+    else
+        key = pdc_color[bg];
+
+    SDL_SetPalette(pdc_font, SDL_LOGPAL, pdc_color + fg, pdc_flastc, 1);
+    SDL_SetPalette(pdc_font, SDL_LOGPAL, &key, 0, 1);
+    SDL_SetColorKey(pdc_font, 0, 0);
+
+    sheet = SDL_ConvertSurface(pdc_font, pdc_screen->format, 0);
+
+    if (sheet && bg == -1)
+        SDL_SetColorKey(sheet, SDL_SRCCOLORKEY,
+                        SDL_MapRGB(sheet->format, key.r, key.g, key.b));
+
+    return sheet;
+}
+
+/* Return the surface to blit glyphs from, in the current colors. The
+   sheets are made as needed; when the cache is full, the least recently
+   used one is replaced. If a sheet can't be made, fall back to
+   recoloring the font's own palette. */
+
+static SDL_Surface *_get_sheet(void)
+{
+    int i, victim = 0;
+
+    if (SP->mono)
+        return pdc_font;
+
+    for (i = 0; i < MAXSHEET; i++)
+    {
+        if (sheets[i].sheet && sheets[i].fg == foregr &&
+            sheets[i].bg == backgr)
         {
-#ifndef PDC_WIDE
-            if (newbg == -1)
-                SDL_SetColorKey(pdc_font, SDL_SRCCOLORKEY, 0);
-            else
-            {
-                if (backgr == -1)
-                    SDL_SetColorKey(pdc_font, 0, 0);
+            sheets[i].used = ++sheetclock;
+            return sheets[i].sheet;
+        }
+
+        if (sheets[i].used < sheets[victim].used)
+            victim = i;
+    }
+
+    if (sheets[victim].sheet)
+        SDL_FreeSurface(sheets[victim].sheet);
+
+    sheets[victim].sheet = _make_sheet(foregr, backgr);
+
+    if (!sheets[victim].sheet)
+    {
+        sheets[victim].used = 0;
+        SDL_SetColorKey(pdc_font, (backgr == -1) ? SDL_SRCCOLORKEY : 0, 0);
+        return pdc_font;
+    }
+
+    sheets[victim].fg = foregr;
+    sheets[victim].bg = backgr;
+    sheets[victim].used = ++sheetclock;
+
+    return sheets[victim].sheet;
+}
 
-                SDL_SetPalette(pdc_font, SDL_LOGPAL,
-                               pdc_color + newbg, 0, 1);
-            }
 #endif
-            backgr = newbg;
-        }
 
-        oldch = ch;
+/* Discard the pre-colored font sheets, after a color or the screen
+   format changes */
+
+void PDC_free_sheets(void)
+{
+#ifndef PDC_WIDE
+    int i;
+
+    for (i = 0; i < MAXSHEET; i++)
+    {
+        if (sheets[i].sheet)
+            SDL_FreeSurface(sheets[i].sheet);
+
+        sheets[i].sheet = NULL;
+        sheets[i].used = 0;
     }
+
+    sheetclock = 0;
+#endif
 }
 
 #ifdef PDC_WIDE
@@ -225,6 +323,8 @@ void PDC_gotoyx(int row, int col)
     int oldrow, oldcol;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
+#else
+    SDL_Surface *sheet;
 #endif
 
     PDC_LOG(("PDC_gotoyx() - called: row %d col %d from row %d col %d\n",
@@ -235,7 +335,7 @@ void PDC_gotoyx(int row, int col)
 
     /* clear the old cursor */
 
-    PDC_transform_line(oldrow, oldcol, 1, curscr->_y[oldrow] + oldcol);
+    PDC_transform_line(oldrow, oldcol, 1, SP->lastscr->_y[oldrow] + oldcol);
 
     if (!SP->visibility)
         return;
@@ -244,9 +344,12 @@ void PDC_gotoyx(int row, int col)
        reverse, either the full cell (when visibility == 2) or the
        lowest quarter of it (when visibility == 1) */
 
-    ch = curscr->_y[row][col] ^ A_REVERSE;
+    ch = SP->lastscr->_y[row][col] ^ A_REVERSE;
 
     _set_attr(ch);
+#ifndef PDC_WIDE
+    sheet = _get_sheet();
+#endif
 
     src.h = (SP->visibility == 1) ? pdc_fheight >> 2 : pdc_fheight;
     src.w = pdc_fwidth;
@@ -289,7 +392,7 @@ void PDC_gotoyx(int row, int col)
     src.x = (ch & 0xff) % 32 * pdc_fwidth;
     src.y = (ch & 0xff) / 32 * pdc_fheight + (pdc_fheight - src.h);
 
-    SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
+    SDL_BlitSurface(sheet, &src, pdc_screen, &dest);
 #endif
 
     if (oldrow != row || oldcol != col)
@@ -307,6 +410,8 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     int j;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
+#else
+    SDL_Surface *sheet;
 #endif
     attr_t sysattrs = SP->termattrs;
     short hcol = SP->line_color;
@@ -331,21 +436,27 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
        and horizontal position, then merge the new one with it instead
        of adding a new entry */
 
-    if (rectcount)
-        lastrect = uprect[rectcount - 1];
-
-    if (rectcount && lastrect.x == dest.x && lastrect.w == dest.w)
+    if (!span_rects)
     {
-        if (lastrect.y + lastrect.h == dest.y)
-            uprect[rectcount - 1].h = lastrect.h + pdc_fheight;
+        if (rectcount)
+            lastrect = uprect[rectcount - 1];
+
+        if (rectcount && lastrect.x == dest.x && lastrect.w == dest.w)
+        {
+            if (lastrect.y + lastrect.h == dest.y)
+                uprect[rectcount - 1].h = lastrect.h + pdc_fheight;
+            else
+                if (lastrect.y != dest.y)
+                    uprect[rectcount++] = dest;
+        }
         else
-            if (lastrect.y != dest.y)
-                uprect[rectcount++] = dest;
+            uprect[rectcount++] = dest;
     }
-    else
-        uprect[rectcount++] = dest;
 
     _set_attr(attr);
+#ifndef PDC_WIDE
+    sheet = _get_sheet();
+#endif
 
     if (backgr == -1)
         SDL_LowerBlit(pdc_tileback, &dest, pdc_screen, &dest);
@@ -407,7 +518,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         src.x = (ch & 0xff) % 32 * pdc_fwidth;
         src.y = (ch & 0xff) / 32 * pdc_fheight;
 
-        SDL_LowerBlit(pdc_font, &src, pdc_screen, &dest);
+        SDL_LowerBlit(sheet, &src, pdc_screen, &dest);
 #endif
 
         if (!blink && (attr & (A_LEFT | A_RIGHT)))
@@ -476,6 +587,71 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
     _new_packet(old_attr, lineno, x, i, srcp);
 }
 
+/* draw one changed run as part of a whole update; its rect is merged
+   with the previous one if they overlap or touch */
+
+static void _draw_span(int lineno, int x, int len, const chtype *srcp)
+{
+    SDL_Rect dest, *last;
+
+    span_rects = TRUE;
+    PDC_transform_line(lineno, x, len, srcp);
+    span_rects = FALSE;
+
+    if (update_all)
+        return;
+
+    dest.y = pdc_fheight * lineno + pdc_yoffset;
+    dest.x = pdc_fwidth * x + pdc_xoffset;
+    dest.h = pdc_fheight;
+    dest.w = pdc_fwidth * len;
+
+    last = rectcount ? uprect + rectcount - 1 : NULL;
+
+    if (last && dest.y <= last->y + last->h && last->y <= dest.y + dest.h &&
+        dest.x <= last->x + last->w && last->x <= dest.x + dest.w)
+    {
+        int right = max(last->x + last->w, dest.x + dest.w);
+        int bottom = max(last->y + last->h, dest.y + dest.h);
+
+        last->x = min(last->x, dest.x);
+        last->y = min(last->y, dest.y);
+        last->w = right - last->x;
+        last->h = bottom - last->y;
+    }
+    else
+    {
+        if (rectcount == MAXRECT)
+            PDC_update_rects();
+
+        uprect[rectcount++] = dest;
+    }
+}
+
+/* doupdate()'s changes, all at once; if they cover more than half the
+   screen, flip the whole thing instead of the changed rects */
+
+void PDC_transform_spans(const PDC_SPAN *spans, int count)
+{
+    long cells = 0;
+    int i;
+
+    PDC_LOG(("PDC_transform_spans() - called: count=%d\n", count));
+
+    /* pairs may have been redefined since the last update */
+
+    oldch = (chtype)(-1);
+
+    for (i = 0; i < count; i++)
+        cells += spans[i].len;
+
+    if (cells * 2 > (long)SP->lines * SP->cols)
+        update_all = TRUE;
+
+    for (i = 0; i < count; i++)
+        _draw_span(spans[i].y, spans[i].x, spans[i].len, spans[i].srcp);
+}
+
 static Uint32 _blink_timer(Uint32 interval, void *param)
 {
     SDL_Event event;
@@ -485,45 +661,43 @@ static Uint32 _blink_timer(Uint32 interval, void *param)
     return(interval);
 }
 
-void PDC_blink_text(void)
-{
-    static SDL_TimerID blinker_id = 0;
-    int i, j, k;
-
-    oldch = (chtype)(-1);
+/* run the blink timer only while blinking is enabled and something on
+   the screen actually blinks */
 
-    if (!(SP->termattrs & A_BLINK))
+static void _set_blinker(void)
+{
+    if ((SP->termattrs & A_BLINK) && SP->opaque->blinkcount)
     {
-        SDL_RemoveTimer(blinker_id);
-        blinker_id = 0;
+        if (!blinker_id)
+            blinker_id = SDL_AddTimer(500, _blink_timer, NULL);
     }
-    else if (!blinker_id)
+    else if (blinker_id)
     {
-        blinker_id = SDL_AddTimer(500, _blink_timer, NULL);
-        blinked_off = TRUE;
+        SDL_RemoveTimer(blinker_id);
+        blinker_id = 0;
+        blinked_off = FALSE;
     }
+}
 
-    blinked_off = !blinked_off;
+void PDC_blink_text(void)
+{
+    bool ticking = !!blinker_id;
 
-    for (i = 0; i < SP->lines; i++)
-    {
-        const chtype *srcp = curscr->_y[i];
+    _set_blinker();
 
-        for (j = 0; j < SP->cols; j++)
-            if (srcp[j] & A_BLINK)
-            {
-                k = j;
-                while (k < SP->cols && (srcp[k] & A_BLINK))
-                    k++;
-                PDC_transform_line(i, j, k - j, srcp + j);
-                j = k;
-            }
-    }
+    /* toggle on timer ticks; otherwise, (re)show the text */
+
+    blinked_off = (ticking && blinker_id) ? !blinked_off : FALSE;
+
+    oldch = (chtype)(-1);
+
+    PDC_redraw_blink();
 
     oldch = (chtype)(-1);
 }
 
 void PDC_doupdate(void)
 {
+    _set_blinker();
     PDC_napms(1);
 }
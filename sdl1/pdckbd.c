@@ -7,6 +7,8 @@
 static SDL_Event event;
 static SDLKey oldkey;
 static MOUSE_STATUS old_mouse_status;
+static bool resize_pending = FALSE, resize_due = FALSE;
+static Uint32 resize_stamp;
 
 static struct
 {
@@ -81,7 +83,20 @@ void PDC_set_keyboard_binary(bool on)
 
 bool PDC_check_key(void)
 {
-    int haveevent = SDL_PollEvent(&event);
+    int haveevent;
+
+    /* report a burst of resize events once it has settled */
+
+    if (resize_pending && SDL_GetTicks() - resize_stamp >= PDC_RESIZE_SETTLE)
+    {
+        resize_pending = FALSE;
+        resize_due = TRUE;
+    }
+
+    if (resize_due)
+        return TRUE;
+
+    haveevent = SDL_PollEvent(&event);
 
     return haveevent;
 }
@@ -274,22 +289,11 @@ static int _process_mouse_event(void)
         if (btn < 1 || btn > 3)
             return -1;
 
-        /* check for a click -- a press followed immediately by a release */
+        /* turn a release soon enough after its press into a click --
+           SDL 1.2 events carry no timestamp, so use the time now */
 
-        if (action == BUTTON_PRESSED && SP->mouse_wait)
-        {
-            SDL_Event rel;
-
-            napms(SP->mouse_wait);
-
-            if (SDL_PollEvent(&rel))
-            {
-                if (rel.type == SDL_MOUSEBUTTONUP && rel.button.button == btn)
-                    action = BUTTON_CLICKED;
-                else
-                    SDL_PushEvent(&rel);
-            }
-        }
+        action = PDC_mouse_click(btn, action == BUTTON_PRESSED,
+                                 SDL_GetTicks());
 
         SP->mouse_status.x = (event.button.x - pdc_xoffset) / pdc_fwidth;
         SP->mouse_status.y = (event.button.y - pdc_yoffset) / pdc_fheight;
@@ -310,6 +314,20 @@ static int _process_mouse_event(void)
 
 int PDC_get_key(void)
 {
+    if (resize_due)
+    {
+        resize_due = FALSE;
+
+        if (!SP->resized)
+        {
+            SP->resized = TRUE;
+            SP->key_code = TRUE;
+            return KEY_RESIZE;
+        }
+
+        return -1;
+    }
+
     switch (event.type)
     {
     case SDL_QUIT:
@@ -322,12 +340,8 @@ int PDC_get_key(void)
             pdc_sheight = event.resize.h;
             pdc_swidth = event.resize.w;
 
-            if (!SP->resized)
-            {
-                SP->resized = TRUE;
-                SP->key_code = TRUE;
-                return KEY_RESIZE;
-            }
+            resize_pending = TRUE;
+            resize_stamp = SDL_GetTicks();
         }
         break;
     case SDL_MOUSEMOTION:
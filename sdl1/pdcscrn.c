@@ -39,6 +39,7 @@ static void _clean(void)
     SDL_FreeSurface(pdc_tileback);
     SDL_FreeSurface(pdc_back);
     SDL_FreeSurface(pdc_icon);
+    PDC_free_sheets();
     SDL_FreeSurface(pdc_font);
 
     SDL_Quit();
@@ -275,6 +276,8 @@ int PDC_scr_open(void)
     SP->mouse_wait = PDC_CLICK_PERIOD;
     SP->audible = FALSE;
 
+    PDC_transform_frame = PDC_transform_spans;
+
     SP->termattrs = A_COLOR | A_UNDERLINE | A_LEFT | A_RIGHT | A_REVERSE;
 #ifdef PDC_WIDE
     SP->termattrs |= A_ITALIC;
@@ -307,6 +310,8 @@ int PDC_resize_screen(int nlines, int ncols)
     pdc_screen = SDL_SetVideoMode(pdc_swidth, pdc_sheight, 0,
         SDL_SWSURFACE|SDL_ANYFORMAT|SDL_RESIZABLE);
 
+    PDC_free_sheets();
+
     if (pdc_tileback)
         PDC_retile();
 
@@ -360,5 +365,7 @@ int PDC_init_color(short color, short red, short green, short blue)
     pdc_mapped[color] = SDL_MapRGB(pdc_screen->format, pdc_color[color].r,
                                    pdc_color[color].g, pdc_color[color].b);
 
+    PDC_free_sheets();
+
     return OK;
 }
@@ -32,3 +32,5 @@ PDCEX  void PDC_update_rects(void);
 PDCEX  void PDC_retile(void);
 
 extern void PDC_blink_text(void);
+extern void PDC_transform_spans(const PDC_SPAN *, int);
+extern void PDC_free_sheets(void);
@@ -17,9 +17,48 @@
 
 static SDL_Rect uprect[MAXRECT];       /* table of rects to update */
 static chtype oldch = (chtype)(-1);    /* current attribute */
+static int oldfg = -2, oldbg = -2;     /* ...and its pair's colors */
 static int rectcount = 0;              /* index into uprect */
+static bool span_rects = FALSE;        /* rects come from _draw_span(),
+                                          not from each packet */
+static bool update_all = FALSE;        /* push the whole window next */
 static short foregr = -2, backgr = -2; /* current foreground, background */
-static bool blinked_off = FALSE;
+static bool blinked_off = FALSE;      /* under draw_lock, if threaded */
+static SDL_TimerID blinker_id = 0;     /* text blink timer */
+
+/* the settings to draw with: SP's, or on the render thread, the copies
+   in the frame it's drawing */
+
+static attr_t drawattrs = 0;           /* SP->termattrs */
+static short drawline = -1;            /* SP->line_color */
+static bool drawmono = FALSE;          /* SP->mono */
+
+#ifndef PDC_WIDE
+# define MAXSHEET 32    /* maximum number of pre-colored font sheets to
+                           keep; each is a copy of the font */
+
+static struct
+{
+    SDL_Surface *sheet;
+    short fg, bg;
+    unsigned long used;
+} sheets[MAXSHEET];                    /* font sheets, by color pair */
+static unsigned long sheetclock = 0;   /* for least recently used */
+#endif
+
+/* The optional render thread. The application's thread collects each
+   update in "building", and hands it over to "pending" at the end of
+   doupdate(). The renderer takes "pending" into "shown", its copy of
+   the screen, and draws the changes from there. */
+
+static SDL_Thread *renderer = NULL;
+static SDL_threadID renderer_id;
+static SDL_mutex *frame_lock = NULL;   /* guards pending */
+static SDL_mutex *draw_lock = NULL;    /* held while drawing */
+static SDL_cond *frame_ready = NULL;
+static bool renderer_quit = FALSE;
+static PDC_FRAME building, pending, shown;
+static int drawn_row, drawn_col;       /* cursor, as drawn */
 
 /* do the real updates on a delay */
 
@@ -27,11 +66,18 @@ void PDC_update_rects(void)
 {
     int i;
 
-    if (rectcount)
-    {
-        /* if the maximum number of rects has been reached, we're
-           probably better off doing a full screen update */
+    /* if most of the screen changed, or the maximum number of rects has
+       been reached, we're probably better off doing a full screen
+       update */
 
+    if (update_all)
+    {
+        SDL_UpdateWindowSurface(pdc_window);
+        update_all = FALSE;
+        rectcount = 0;
+    }
+    else if (rectcount)
+    {
         if (rectcount == MAXRECT)
             SDL_UpdateWindowSurface(pdc_window);
         else
@@ -70,11 +116,73 @@ void PDC_update_rects(void)
     }
 }
 
-/* set the font colors to match the chtype's attribute */
+#ifdef A_RGB_COLOR
+
+/* Direct colors are given slots in pdc_color[] and pdc_mapped[], past
+   PDC_MAXCOL, so that the rest of the drawing code (and the font
+   sheets) can treat them like any other color. Each RGB value maps to a
+   set of two slots; when neither holds it, the less recently used one
+   is taken over, unless that's keep. Keys are offset by one, so that an
+   empty slot matches nothing. */
+
+static struct
+{
+    unsigned long rgb;
+    unsigned long used;
+} rgbslot[PDC_RGB_SLOTS];
+static unsigned long rgbclock = 0;
+
+static short _rgb_color(unsigned long rgb, short keep)
+{
+    int i = ((rgb ^ (rgb >> 8) ^ (rgb >> 16)) & (PDC_RGB_SLOTS / 2 - 1)) * 2;
+
+    if (rgbslot[i + 1].rgb == rgb + 1)
+        i++;
+    else if (rgbslot[i].rgb != rgb + 1)
+    {
+        SDL_Color *c;
+#ifndef PDC_WIDE
+        int j;
+#endif
+        if (PDC_MAXCOL + i == keep || (PDC_MAXCOL + i + 1 != keep &&
+            rgbslot[i + 1].used < rgbslot[i].used))
+            i++;
+
+        c = pdc_color + PDC_MAXCOL + i;
+        c->r = (rgb >> 16) & 0xff;
+        c->g = (rgb >> 8) & 0xff;
+        c->b = rgb & 0xff;
+
+        pdc_mapped[PDC_MAXCOL + i] = SDL_MapRGB(pdc_screen->format,
+                                                c->r, c->g, c->b);
+        rgbslot[i].rgb = rgb + 1;
+#ifndef PDC_WIDE
+        /* the sheets drawn in the old color are no good now */
+
+        for (j = 0; j < MAXSHEET; j++)
+            if (sheets[j].sheet && (sheets[j].fg == PDC_MAXCOL + i ||
+                                    sheets[j].bg == PDC_MAXCOL + i))
+            {
+                SDL_FreeSurface(sheets[j].sheet);
+                sheets[j].sheet = NULL;
+                sheets[j].used = 0;
+            }
+#endif
+    }
+
+    rgbslot[i].used = ++rgbclock;
+
+    return PDC_MAXCOL + i;
+}
+
+#endif
+
+/* set the colors to match the chtype's attribute; fg and bg are its
+   pair's colors */
 
-static void _set_attr(chtype ch)
+static void _set_attr(chtype ch, int fg, int bg)
 {
-    attr_t sysattrs = SP->termattrs;
+    attr_t sysattrs = drawattrs;
 
 #ifdef PDC_WIDE
     TTF_SetFontStyle(pdc_ttffont,
@@ -86,55 +194,248 @@ static void _set_attr(chtype ch)
 
     ch &= (A_COLOR|A_BOLD|A_BLINK|A_REVERSE);
 
-    if (oldch != ch)
+    if (oldch != ch || oldfg != fg || oldbg != bg)
     {
-        short newfg, newbg;
+        int newfg = fg, newbg = bg;
 
-        if (SP->mono)
+        if (drawmono)
             return;
 
-        pair_content(PAIR_NUMBER(ch), &newfg, &newbg);
-
-        if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
-            newfg |= 8;
-        if ((ch & A_BLINK) && !(sysattrs & A_BLINK))
-            newbg |= 8;
+#ifdef A_RGB_COLOR
+        if (ch & A_RGB_COLOR)
+        {
+            newfg = _rgb_color(PDC_RGB_FORE(ch), -1);
+            newbg = _rgb_color(PDC_RGB_BACK(ch), newfg);
+        }
+        else
+#endif
+        {
+            if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
+                newfg |= 8;
+            if ((ch & A_BLINK) && !(sysattrs & A_BLINK))
+                newbg |= 8;
+        }
 
         if (ch & A_REVERSE)
         {
-            short tmp = newfg;
+            int tmp = newfg;
             newfg = newbg;
             newbg = tmp;
         }
 
-        if (newfg != foregr)
-        {
+        foregr = newfg;
+        backgr = newbg;
+
+        oldch = ch;
+        oldfg = fg;
+        oldbg = bg;
+    }
+}
+
 #ifndef PDC_WIDE
-            SDL_SetPaletteColors(pdc_font->format->palette,
-                                 pdc_color + newfg, pdc_flastc, 1);
-#endif
-            foregr = newfg;
-        }
 
-        if (newbg != backgr)
+/* Build a copy of the font in the screen's pixel format, with glyphs
+   in color fg on bg. Where bg is -1, the background is transparent: it
+   gets a color unlike fg, which is made the color key. */
+
+static SDL_Surface *_make_sheet(short fg, short bg)
+{
+    SDL_Surface *sheet;
+    SDL_Color key;
+
+    if (bg == -1)
+    {
+        key.r = pdc_color[fg].r ^ 0x80;
+        key.g = pdc_color[fg].g ^ 0x80;
+        key.b = pdc_color[fg].b ^ 0x80;
+    }
+    else
+        key = pdc_color[bg];
+
+    SDL_SetPaletteColors(pdc_font->format->palette, pdc_color + fg,
+                         pdc_flastc, 1);
+    SDL_SetPaletteColors(pdc_font->format->palette, &key, 0, 1);
+    SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
+
+    sheet = SDL_ConvertSurface(pdc_font, pdc_screen->format, 0);
+
+    if (sheet && bg == -1)
+        SDL_SetColorKey(sheet, SDL_TRUE,
+                        SDL_MapRGB(sheet->format, key.r, key.g, key.b));
+
+    return sheet;
+}
+
+/* Return the surface to blit glyphs from, in the current colors. The
+   sheets are made as needed; when the cache is full, the least recently
+   used one is replaced. If a sheet can't be made, fall back to
+   recoloring the font's own palette. */
+
+static SDL_Surface *_get_sheet(void)
+{
+    int i, victim = 0;
+
+    if (drawmono)
+        return pdc_font;
+
+    for (i = 0; i < MAXSHEET; i++)
+    {
+        if (sheets[i].sheet && sheets[i].fg == foregr &&
+            sheets[i].bg == backgr)
         {
+            sheets[i].used = ++sheetclock;
+            return sheets[i].sheet;
+        }
+
+        if (sheets[i].used < sheets[victim].used)
+            victim = i;
+    }
+
+    if (sheets[victim].sheet)
+        SDL_FreeSurface(sheets[victim].sheet);
+
+    sheets[victim].sheet = _make_sheet(foregr, backgr);
+
+    if (!sheets[victim].sheet)
+    {
+        sheets[victim].used = 0;
+        SDL_SetColorKey(pdc_font, (backgr == -1) ? SDL_TRUE : SDL_FALSE, 0);
+        return pdc_font;
+    }
+
+    sheets[victim].fg = foregr;
+    sheets[victim].bg = backgr;
+    sheets[victim].used = ++sheetclock;
+
+    return sheets[victim].sheet;
+}
+
+#endif
+
+/* Discard the pre-colored font sheets, after a color or the screen
+   format changes; and the mapped direct colors, with the latter */
+
+void PDC_free_sheets(void)
+{
 #ifndef PDC_WIDE
-            if (newbg == -1)
-                SDL_SetColorKey(pdc_font, SDL_TRUE, 0);
-            else
-            {
-                if (backgr == -1)
-                    SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
+    int i;
 
-                SDL_SetPaletteColors(pdc_font->format->palette,
-                                     pdc_color + newbg, 0, 1);
-            }
+    for (i = 0; i < MAXSHEET; i++)
+    {
+        if (sheets[i].sheet)
+            SDL_FreeSurface(sheets[i].sheet);
+
+        sheets[i].sheet = NULL;
+        sheets[i].used = 0;
+    }
+
+    sheetclock = 0;
 #endif
-            backgr = newbg;
-        }
+#ifdef A_RGB_COLOR
+    memset(rgbslot, 0, sizeof(rgbslot));
+    rgbclock = 0;
+#endif
+}
 
-        oldch = ch;
+/* TRUE when drawing should be passed to the render thread */
+
+static bool _app_side(void)
+{
+    return renderer && SDL_ThreadID() != renderer_id;
+}
+
+/* the screen as drawn so far */
+
+static const chtype *_drawn(int y, int x)
+{
+    return renderer ? shown.cells + y * shown.cols + x :
+                      SP->lastscr->_y[y] + x;
+}
+
+/* ...and its colors, or NULL when they're to be looked up */
+
+static const short *_drawn_fore(int y, int x)
+{
+    return renderer ? shown.fore + y * shown.cols + x : NULL;
+}
+
+static const short *_drawn_back(int y, int x)
+{
+    return renderer ? shown.back + y * shown.cols + x : NULL;
+}
+
+/* take the settings to draw with from f, or from SP if f is NULL */
+
+static void _use_settings(const PDC_FRAME *f)
+{
+    drawattrs = f ? f->termattrs : SP->termattrs;
+    drawline = f ? f->line_color : SP->line_color;
+    drawmono = f ? f->mono : SP->mono;
+}
+
+/* the colors of the pair of cell ch */
+
+static void _pair_colors(chtype ch, int *fg, int *bg)
+{
+#ifdef A_RGB_COLOR
+    if (ch & A_RGB_COLOR)
+    {
+        *fg = *bg = -1;
+        return;
     }
+#endif
+    extended_pair_content(PAIR_NUMBER(ch), fg, bg);
+}
+
+/* Keep the render thread off pdc_screen, while the application's
+   thread changes or draws on it directly */
+
+void PDC_lock_display(void)
+{
+    if (renderer)
+        SDL_LockMutex(draw_lock);
+}
+
+void PDC_unlock_display(void)
+{
+    if (renderer)
+        SDL_UnlockMutex(draw_lock);
+}
+
+/* size the frames to match the screen; what they held is lost, but
+   anything that changes the screen size redraws it completely */
+
+static int _resize_frames(void)
+{
+    int rc;
+
+    SDL_LockMutex(draw_lock);
+    SDL_LockMutex(frame_lock);
+
+    rc = (PDC_frame_resize(&building, SP->lines, SP->cols) == OK &&
+          PDC_frame_resize(&pending, SP->lines, SP->cols) == OK &&
+          PDC_frame_resize(&shown, SP->lines, SP->cols) == OK) ? OK : ERR;
+
+    drawn_row = drawn_col = 0;
+
+    SDL_UnlockMutex(frame_lock);
+    SDL_UnlockMutex(draw_lock);
+
+    return rc;
+}
+
+/* pass whatever doupdate() has collected to the render thread; if it
+   hasn't finished with the last lot, the two are merged */
+
+static void _hand_off(void)
+{
+    if (!building.ready)
+        return;
+
+    SDL_LockMutex(frame_lock);
+    PDC_frame_take(&pending, &building);
+    SDL_CondSignal(frame_ready);
+    SDL_UnlockMutex(frame_lock);
 }
 
 #ifdef PDC_WIDE
@@ -247,39 +548,51 @@ bool _grprint(chtype ch, SDL_Rect dest)
 
 #endif
 
-/* draw a cursor at (y, x) */
+static void _draw_line(int, int, int, const chtype *, const short *,
+                       const short *);
 
-void PDC_gotoyx(int row, int col)
+/* move the cursor from (oldrow, oldcol) to (row, col) */
+
+static void _draw_cursor(int oldrow, int oldcol, int row, int col,
+                         int visibility)
 {
     SDL_Rect src, dest;
     chtype ch;
-    int oldrow, oldcol;
+    int fg, bg;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
+#else
+    SDL_Surface *sheet;
 #endif
 
-    PDC_LOG(("PDC_gotoyx() - called: row %d col %d from row %d col %d\n",
-             row, col, SP->cursrow, SP->curscol));
-
-    oldrow = SP->cursrow;
-    oldcol = SP->curscol;
-
     /* clear the old cursor */
 
-    PDC_transform_line(oldrow, oldcol, 1, curscr->_y[oldrow] + oldcol);
+    _draw_line(oldrow, oldcol, 1, _drawn(oldrow, oldcol),
+               _drawn_fore(oldrow, oldcol), _drawn_back(oldrow, oldcol));
 
-    if (!SP->visibility)
+    if (!visibility)
         return;
 
     /* draw a new cursor by overprinting the existing character in
        reverse, either the full cell (when visibility == 2) or the
        lowest quarter of it (when visibility == 1) */
 
-    ch = curscr->_y[row][col] ^ A_REVERSE;
+    ch = *_drawn(row, col) ^ A_REVERSE;
 
-    _set_attr(ch);
+    if (renderer)
+    {
+        fg = *_drawn_fore(row, col);
+        bg = *_drawn_back(row, col);
+    }
+    else
+        _pair_colors(ch, &fg, &bg);
 
-    src.h = (SP->visibility == 1) ? pdc_fheight >> 2 : pdc_fheight;
+    _set_attr(ch, fg, bg);
+#ifndef PDC_WIDE
+    sheet = _get_sheet();
+#endif
+
+    src.h = (visibility == 1) ? pdc_fheight >> 2 : pdc_fheight;
     src.w = pdc_fwidth;
 
     dest.y = (row + 1) * pdc_fheight - src.h + pdc_yoffset;
@@ -290,7 +603,7 @@ void PDC_gotoyx(int row, int col)
 #ifdef PDC_WIDE
     SDL_FillRect(pdc_screen, &dest, pdc_mapped[backgr]);
 
-    if (!(SP->visibility == 2 && (ch & A_ALTCHARSET && !(ch & 0xff80)) &&
+    if (!(visibility == 2 && (ch & A_ALTCHARSET && !(ch & 0xff80)) &&
         _grprint(ch & (0x7f | A_ALTCHARSET), dest)))
     {
         if (ch & A_ALTCHARSET && !(ch & 0xff80))
@@ -320,7 +633,7 @@ void PDC_gotoyx(int row, int col)
     src.x = (ch & 0xff) % 32 * pdc_fwidth;
     src.y = (ch & 0xff) / 32 * pdc_fheight + (pdc_fheight - src.h);
 
-    SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
+    SDL_BlitSurface(sheet, &src, pdc_screen, &dest);
 #endif
 
     if (oldrow != row || oldcol != col)
@@ -332,15 +645,38 @@ void PDC_gotoyx(int row, int col)
     }
 }
 
-void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
+/* draw a cursor at (y, x) */
+
+void PDC_gotoyx(int row, int col)
+{
+    PDC_LOG(("PDC_gotoyx() - called: row %d col %d from row %d col %d\n",
+             row, col, SP->cursrow, SP->curscol));
+
+    if (_app_side())
+    {
+        building.cursrow = row;
+        building.curscol = col;
+        building.visibility = SP->visibility;
+        building.ready = TRUE;
+        return;
+    }
+
+    _use_settings(NULL);
+    _draw_cursor(SP->cursrow, SP->curscol, row, col, SP->visibility);
+}
+
+void _new_packet(attr_t attr, int fg, int bg, int lineno, int x, int len,
+                 const chtype *srcp)
 {
     SDL_Rect src, dest, lastrect;
     int j;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
+#else
+    SDL_Surface *sheet;
 #endif
-    attr_t sysattrs = SP->termattrs;
-    short hcol = SP->line_color;
+    attr_t sysattrs = drawattrs;
+    short hcol = drawline;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
     if (rectcount == MAXRECT)
@@ -362,21 +698,27 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
        and horizontal position, then merge the new one with it instead
        of adding a new entry */
 
-    if (rectcount)
-        lastrect = uprect[rectcount - 1];
-
-    if (rectcount && lastrect.x == dest.x && lastrect.w == dest.w)
+    if (!span_rects)
     {
-        if (lastrect.y + lastrect.h == dest.y)
-            uprect[rectcount - 1].h = lastrect.h + pdc_fheight;
+        if (rectcount)
+            lastrect = uprect[rectcount - 1];
+
+        if (rectcount && lastrect.x == dest.x && lastrect.w == dest.w)
+        {
+            if (lastrect.y + lastrect.h == dest.y)
+                uprect[rectcount - 1].h = lastrect.h + pdc_fheight;
+            else
+                if (lastrect.y != dest.y)
+                    uprect[rectcount++] = dest;
+        }
         else
-            if (lastrect.y != dest.y)
-                uprect[rectcount++] = dest;
+            uprect[rectcount++] = dest;
     }
-    else
-        uprect[rectcount++] = dest;
 
-    _set_attr(attr);
+    _set_attr(attr, fg, bg);
+#ifndef PDC_WIDE
+    sheet = _get_sheet();
+#endif
 
     if (backgr == -1)
         SDL_BlitSurface(pdc_tileback, &dest, pdc_screen, &dest);
@@ -438,7 +780,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         src.x = (ch & 0xff) % 32 * pdc_fwidth;
         src.y = (ch & 0xff) / 32 * pdc_fheight;
 
-        SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
+        SDL_BlitSurface(sheet, &src, pdc_screen, &dest);
 #endif
 
         if (!blink && (attr & (A_LEFT | A_RIGHT)))
@@ -478,15 +820,34 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     }
 }
 
-/* update the given physical line to look like the corresponding line in
-   curscr */
+/* draw a packet of cells in attribute attr; its colors come from fore
+   and back, or if they're NULL, from the pair */
 
-void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+static void _draw_packet(attr_t attr, int lineno, int x, int len,
+                         const chtype *srcp, const short *fore,
+                         const short *back)
 {
-    attr_t old_attr, attr;
-    int i, j;
+    int fg, bg;
 
-    PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
+    if (fore)
+    {
+        fg = *fore;
+        bg = *back;
+    }
+    else
+        _pair_colors(attr, &fg, &bg);
+
+    _new_packet(attr, fg, bg, lineno, x, len, srcp);
+}
+
+/* draw len cells of row lineno from x, split into runs of the same
+   attribute */
+
+static void _draw_line(int lineno, int x, int len, const chtype *srcp,
+                       const short *fore, const short *back)
+{
+    attr_t old_attr, attr;
+    int i, j, start = 0;
 
     old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
 
@@ -496,15 +857,191 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 
         if (attr != old_attr)
         {
-            _new_packet(old_attr, lineno, x, i, srcp);
+            _draw_packet(old_attr, lineno, x, i, srcp,
+                         fore ? fore + start : NULL,
+                         back ? back + start : NULL);
             old_attr = attr;
             srcp += i;
             x += i;
+            start += i;
             i = 0;
         }
     }
 
-    _new_packet(old_attr, lineno, x, i, srcp);
+    _draw_packet(old_attr, lineno, x, i, srcp, fore ? fore + start : NULL,
+                 back ? back + start : NULL);
+}
+
+/* update the given physical line to look like the corresponding line in
+   curscr */
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+    PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
+
+    if (_app_side())
+    {
+        if ((building.lines != SP->lines || building.cols != SP->cols) &&
+            _resize_frames() == ERR)
+            PDC_render_stop();
+        else
+        {
+            PDC_frame_store(&building, lineno, x, len, srcp);
+            building.ready = TRUE;
+            return;
+        }
+    }
+
+    _use_settings(NULL);
+    _draw_line(lineno, x, len, srcp, NULL, NULL);
+}
+
+/* decide, before drawing a whole update, whether to push the entire
+   window instead of the changed rects */
+
+static void _plan_update(long cells, int lines, int cols)
+{
+    if (cells * 2 > (long)lines * cols)
+        update_all = TRUE;
+}
+
+/* draw one changed run as part of a whole update; its rect is merged
+   with the previous one if they overlap or touch */
+
+static void _draw_span(int lineno, int x, int len, const chtype *srcp,
+                       const short *fore, const short *back)
+{
+    SDL_Rect dest, *last;
+
+    span_rects = TRUE;
+    _draw_line(lineno, x, len, srcp, fore, back);
+    span_rects = FALSE;
+
+    if (update_all)
+        return;
+
+    dest.y = pdc_fheight * lineno + pdc_yoffset;
+    dest.x = pdc_fwidth * x + pdc_xoffset;
+    dest.h = pdc_fheight;
+    dest.w = pdc_fwidth * len;
+
+    last = rectcount ? uprect + rectcount - 1 : NULL;
+
+    if (last && dest.y <= last->y + last->h && last->y <= dest.y + dest.h &&
+        dest.x <= last->x + last->w && last->x <= dest.x + dest.w)
+    {
+        int right = max(last->x + last->w, dest.x + dest.w);
+        int bottom = max(last->y + last->h, dest.y + dest.h);
+
+        last->x = min(last->x, dest.x);
+        last->y = min(last->y, dest.y);
+        last->w = right - last->x;
+        last->h = bottom - last->y;
+    }
+    else
+    {
+        if (rectcount == MAXRECT)
+            PDC_update_rects();
+
+        uprect[rectcount++] = dest;
+    }
+}
+
+/* doupdate()'s changes, all at once */
+
+void PDC_transform_spans(const PDC_SPAN *spans, int count)
+{
+    long cells = 0;
+    int i;
+
+    PDC_LOG(("PDC_transform_spans() - called: count=%d\n", count));
+
+    if (_app_side())
+    {
+        for (i = 0; i < count; i++)
+            PDC_transform_line(spans[i].y, spans[i].x, spans[i].len,
+                               spans[i].srcp);
+        return;
+    }
+
+    /* direct colors may have been given other slots since the last
+       update */
+
+    oldch = (chtype)(-1);
+    _use_settings(NULL);
+
+    for (i = 0; i < count; i++)
+        cells += spans[i].len;
+
+    _plan_update(cells, SP->lines, SP->cols);
+
+    for (i = 0; i < count; i++)
+        _draw_span(spans[i].y, spans[i].x, spans[i].len, spans[i].srcp,
+                   NULL, NULL);
+}
+
+/* Move what's shown in a rectangle of cells, as doupdate() asks when
+   a window or pad scrolls; see PDC_move_rect in IMPLEMNT.md. The render
+   thread works from its own copy of the screen, so it's left to redraw
+   instead. */
+
+int PDC_move_cells(int top, int left, int bottom, int right, int dy, int dx)
+{
+    int bpp = pdc_screen->format->BytesPerPixel;
+    int step = pdc_screen->pitch;
+    int height = (bottom - top + 1 - abs(dy)) * pdc_fheight;
+    int bytes = (right - left + 1 - abs(dx)) * pdc_fwidth * bpp;
+    int row = SP->cursrow, col = SP->curscol;
+    Uint8 *src, *dest;
+    SDL_Rect rect;
+    int i;
+
+    PDC_LOG(("PDC_move_cells() - called: dy %d dx %d\n", dy, dx));
+
+    if (renderer)
+        return ERR;
+
+    /* take the cursor off the screen, so it isn't copied */
+
+    if (row < SP->lines && col < SP->cols)
+        PDC_transform_line(row, col, 1, _drawn(row, col));
+
+    if (SDL_MUSTLOCK(pdc_screen) && SDL_LockSurface(pdc_screen) < 0)
+        return ERR;
+
+    src = (Uint8 *)pdc_screen->pixels +
+          ((dy > 0 ? top + dy : top) * pdc_fheight + pdc_yoffset) * step +
+          ((dx > 0 ? left + dx : left) * pdc_fwidth + pdc_xoffset) * bpp;
+    dest = (Uint8 *)pdc_screen->pixels +
+           ((dy < 0 ? top - dy : top) * pdc_fheight + pdc_yoffset) * step +
+           ((dx < 0 ? left - dx : left) * pdc_fwidth + pdc_xoffset) * bpp;
+
+    /* moving down, start from the bottom */
+
+    if (dy < 0)
+    {
+        src += (height - 1) * step;
+        dest += (height - 1) * step;
+        step = -step;
+    }
+
+    for (i = 0; i < height; i++, src += step, dest += step)
+        memmove(dest, src, bytes);
+
+    if (SDL_MUSTLOCK(pdc_screen))
+        SDL_UnlockSurface(pdc_screen);
+
+    rect.x = left * pdc_fwidth + pdc_xoffset;
+    rect.y = top * pdc_fheight + pdc_yoffset;
+    rect.w = (right - left + 1) * pdc_fwidth;
+    rect.h = (bottom - top + 1) * pdc_fheight;
+
+    if (rectcount == MAXRECT)
+        PDC_update_rects();
+
+    uprect[rectcount++] = rect;
+
+    return OK;
 }
 
 static Uint32 _blink_timer(Uint32 interval, void *param)
@@ -516,49 +1053,67 @@ static Uint32 _blink_timer(Uint32 interval, void *param)
     return(interval);
 }
 
-void PDC_blink_text(void)
+/* the render thread reads blinked_off while it draws */
+
+static void _set_blinked_off(bool off)
 {
-    static SDL_TimerID blinker_id = 0;
-    int i, j, k;
+    PDC_lock_display();
+    blinked_off = off;
+    PDC_unlock_display();
+}
 
-    oldch = (chtype)(-1);
+/* run the blink timer only while blinking is enabled and something on
+   the screen actually blinks */
 
-    if (!(SP->termattrs & A_BLINK))
+static void _set_blinker(void)
+{
+    if ((SP->termattrs & A_BLINK) && SP->opaque->blinkcount)
     {
-        SDL_RemoveTimer(blinker_id);
-        blinker_id = 0;
+        if (!blinker_id)
+            blinker_id = SDL_AddTimer(500, _blink_timer, NULL);
     }
-    else if (!blinker_id)
+    else if (blinker_id)
     {
-        blinker_id = SDL_AddTimer(500, _blink_timer, NULL);
-        blinked_off = TRUE;
+        SDL_RemoveTimer(blinker_id);
+        blinker_id = 0;
+        _set_blinked_off(FALSE);
     }
+}
 
-    blinked_off = !blinked_off;
+void PDC_blink_text(void)
+{
+    bool ticking = !!blinker_id;
 
-    for (i = 0; i < SP->lines; i++)
-    {
-        const chtype *srcp = curscr->_y[i];
+    _set_blinker();
 
-        for (j = 0; j < SP->cols; j++)
-            if (srcp[j] & A_BLINK)
-            {
-                k = j;
-                while (k < SP->cols && (srcp[k] & A_BLINK))
-                    k++;
-                PDC_transform_line(i, j, k - j, srcp + j);
-                j = k;
-            }
+    /* toggle on timer ticks; otherwise, (re)show the text */
+
+    _set_blinked_off((ticking && blinker_id) ? !blinked_off : FALSE);
+
+    if (renderer)
+    {
+        PDC_redraw_blink();
+        _hand_off();
+        return;
     }
 
     oldch = (chtype)(-1);
 
-    PDC_doupdate();
+    PDC_redraw_blink();
+
+    oldch = (chtype)(-1);
+
+    PDC_update_rects();
 }
 
 void PDC_doupdate(void)
 {
-    PDC_update_rects();
+    if (renderer)
+        _hand_off();
+    else
+        PDC_update_rects();
+
+    _set_blinker();
 }
 
 void PDC_pump_and_peep(void)
@@ -571,10 +1126,159 @@ void PDC_pump_and_peep(void)
             (SDL_WINDOWEVENT_RESTORED == event.window.event ||
              SDL_WINDOWEVENT_EXPOSED == event.window.event))
         {
+            PDC_lock_display();
             SDL_UpdateWindowSurface(pdc_window);
             rectcount = 0;
+            PDC_unlock_display();
         }
         else
             SDL_PushEvent(&event);
     }
 }
+
+/* the render thread: wait for an update, then draw it */
+
+static int _render(void *data)
+{
+    for (;;)
+    {
+        long cells;
+        int y;
+
+        SDL_LockMutex(frame_lock);
+
+        while (!pending.ready && !renderer_quit)
+            SDL_CondWait(frame_ready, frame_lock);
+
+        if (!pending.ready)
+        {
+            SDL_UnlockMutex(frame_lock);
+            break;
+        }
+
+        PDC_frame_take(&shown, &pending);
+
+        SDL_UnlockMutex(frame_lock);
+
+        SDL_LockMutex(draw_lock);
+
+        cells = 0;
+        for (y = 0; y < shown.lines; y++)
+            if (shown.firstch[y] != _NO_CHANGE)
+                cells += shown.lastch[y] - shown.firstch[y] + 1;
+
+        _plan_update(cells, shown.lines, shown.cols);
+
+        oldch = (chtype)(-1);
+        _use_settings(&shown);
+
+        for (y = 0; y < shown.lines; y++)
+            if (shown.firstch[y] != _NO_CHANGE)
+            {
+                int first = shown.firstch[y];
+                int at = y * shown.cols + first;
+
+                _draw_span(y, first, shown.lastch[y] - first + 1,
+                           shown.cells + at, shown.fore + at,
+                           shown.back + at);
+
+                shown.firstch[y] = shown.lastch[y] = _NO_CHANGE;
+            }
+
+        _draw_cursor(drawn_row, drawn_col, shown.cursrow, shown.curscol,
+                     shown.visibility);
+
+        drawn_row = shown.cursrow;
+        drawn_col = shown.curscol;
+        shown.ready = FALSE;
+
+        PDC_update_rects();
+
+        SDL_UnlockMutex(draw_lock);
+    }
+
+    return 0;
+}
+
+static void _free_renderer(void)
+{
+    PDC_frame_free(&building);
+    PDC_frame_free(&pending);
+    PDC_frame_free(&shown);
+
+    if (frame_ready)
+        SDL_DestroyCond(frame_ready);
+    if (draw_lock)
+        SDL_DestroyMutex(draw_lock);
+    if (frame_lock)
+        SDL_DestroyMutex(frame_lock);
+
+    frame_ready = NULL;
+    draw_lock = frame_lock = NULL;
+}
+
+/* start drawing on a thread of our own, picking up from what's on the
+   screen now */
+
+int PDC_render_start(void)
+{
+    int y;
+
+    if (renderer)
+        return OK;
+
+    frame_lock = SDL_CreateMutex();
+    draw_lock = SDL_CreateMutex();
+    frame_ready = SDL_CreateCond();
+
+    if (!frame_lock || !draw_lock || !frame_ready ||
+        _resize_frames() == ERR)
+    {
+        _free_renderer();
+        return ERR;
+    }
+
+    for (y = 0; y < shown.lines; y++)
+    {
+        PDC_frame_store(&shown, y, 0, shown.cols, SP->lastscr->_y[y]);
+        shown.firstch[y] = shown.lastch[y] = _NO_CHANGE;
+    }
+
+    drawn_row = building.cursrow = SP->cursrow;
+    drawn_col = building.curscol = SP->curscol;
+    building.visibility = SP->visibility;
+
+    renderer_quit = FALSE;
+    renderer = SDL_CreateThread(_render, "PDCurses renderer", NULL);
+
+    if (!renderer)
+    {
+        _free_renderer();
+        return ERR;
+    }
+
+    renderer_id = SDL_GetThreadID(renderer);
+
+    return OK;
+}
+
+/* let the render thread finish what it has, and go back to drawing
+   directly */
+
+void PDC_render_stop(void)
+{
+    if (!renderer)
+        return;
+
+    _hand_off();
+
+    SDL_LockMutex(frame_lock);
+    renderer_quit = TRUE;
+    SDL_CondSignal(frame_ready);
+    SDL_UnlockMutex(frame_lock);
+
+    SDL_WaitThread(renderer, NULL);
+    renderer = NULL;
+
+    _free_renderer();
+}
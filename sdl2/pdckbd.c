@@ -8,6 +8,8 @@
 static SDL_Event event;
 static SDL_Keycode oldkey;
 static MOUSE_STATUS old_mouse_status;
+static bool resize_pending = FALSE, resize_due = FALSE;
+static Uint32 resize_stamp;
 
 static struct
 {
@@ -85,6 +87,17 @@ bool PDC_check_key(void)
 
     PDC_pump_and_peep();
 
+    /* report a burst of resize events once it has settled */
+
+    if (resize_pending && SDL_GetTicks() - resize_stamp >= PDC_RESIZE_SETTLE)
+    {
+        resize_pending = FALSE;
+        resize_due = TRUE;
+    }
+
+    if (resize_due)
+        return TRUE;
+
     /* SDL_TEXTINPUT can return multiple chars from the IME which we
        should handle before polling for additional events. */
 
@@ -369,22 +382,10 @@ static int _process_mouse_event(void)
         if (btn < 1 || btn > 3)
             return -1;
 
-        /* check for a click -- a press followed immediately by a release */
-
-        if (action == BUTTON_PRESSED && SP->mouse_wait)
-        {
-            SDL_Event rel;
-
-            napms(SP->mouse_wait);
+        /* turn a release soon enough after its press into a click */
 
-            if (SDL_PollEvent(&rel))
-            {
-                if (rel.type == SDL_MOUSEBUTTONUP && rel.button.button == btn)
-                    action = BUTTON_CLICKED;
-                else
-                    SDL_PushEvent(&rel);
-            }
-        }
+        action = PDC_mouse_click(btn, action == BUTTON_PRESSED,
+                                 event.button.timestamp);
 
         SP->mouse_status.x = (event.button.x - pdc_xoffset) / pdc_fwidth;
         SP->mouse_status.y = (event.button.y - pdc_yoffset) / pdc_fheight;
@@ -405,6 +406,23 @@ static int _process_mouse_event(void)
 
 int PDC_get_key(void)
 {
+    if (resize_due)
+    {
+        resize_due = FALSE;
+
+        touchwin(curscr);
+        wrefresh(curscr);
+
+        if (!SP->resized)
+        {
+            SP->resized = TRUE;
+            SP->key_code = TRUE;
+            return KEY_RESIZE;
+        }
+
+        return -1;
+    }
+
     switch (event.type)
     {
     case SDL_QUIT:
@@ -412,18 +430,14 @@ int PDC_get_key(void)
     case SDL_WINDOWEVENT:
         if (SDL_WINDOWEVENT_SIZE_CHANGED == event.window.event)
         {
+            PDC_lock_display();
             pdc_screen = SDL_GetWindowSurface(pdc_window);
             pdc_sheight = pdc_screen->h - pdc_xoffset;
             pdc_swidth = pdc_screen->w - pdc_yoffset;
-            touchwin(curscr);
-            wrefresh(curscr);
+            PDC_unlock_display();
 
-            if (!SP->resized)
-            {
-                SP->resized = TRUE;
-                SP->key_code = TRUE;
-                return KEY_RESIZE;
-            }
+            resize_pending = TRUE;
+            resize_stamp = event.window.timestamp;
         }
         break;
     case SDL_MOUSEMOTION:
@@ -32,13 +32,15 @@ SDL_Surface *pdc_screen = NULL, *pdc_font = NULL, *pdc_icon = NULL,
             *pdc_back = NULL, *pdc_tileback = NULL;
 int pdc_sheight = 0, pdc_swidth = 0, pdc_yoffset = 0, pdc_xoffset = 0;
 
-SDL_Color pdc_color[PDC_MAXCOL];
-Uint32 pdc_mapped[PDC_MAXCOL];
+SDL_Color pdc_color[PDC_MAXCOL + PDC_RGB_SLOTS];
+Uint32 pdc_mapped[PDC_MAXCOL + PDC_RGB_SLOTS];
 int pdc_fheight, pdc_fwidth, pdc_fthick, pdc_flastc;
 bool pdc_own_window;
 
 static void _clean(void)
 {
+    PDC_render_stop();
+
 #ifdef PDC_WIDE
     if (pdc_ttffont)
     {
@@ -49,6 +51,7 @@ static void _clean(void)
     SDL_FreeSurface(pdc_tileback);
     SDL_FreeSurface(pdc_back);
     SDL_FreeSurface(pdc_icon);
+    PDC_free_sheets();
     SDL_FreeSurface(pdc_font);
     SDL_DestroyWindow(pdc_window);
     SDL_Quit();
@@ -93,6 +96,7 @@ void PDC_scr_close(void)
 
 void PDC_scr_free(void)
 {
+    PDC_render_stop();
 }
 
 static void _initialize_colors(void)
@@ -334,6 +338,9 @@ int PDC_scr_open(void)
     SP->mouse_wait = PDC_CLICK_PERIOD;
     SP->audible = FALSE;
 
+    PDC_transform_frame = PDC_transform_spans;
+    PDC_move_rect = PDC_move_cells;
+
     SP->termattrs = A_COLOR | A_UNDERLINE | A_LEFT | A_RIGHT | A_REVERSE;
 #ifdef PDC_WIDE
     SP->termattrs |= A_ITALIC;
@@ -351,6 +358,8 @@ int PDC_resize_screen(int nlines, int ncols)
     if (!pdc_own_window)
         return ERR;
 
+    PDC_lock_display();
+
     if (nlines && ncols)
     {
 #if SDL_VERSION_ATLEAST(2, 0, 5)
@@ -374,9 +383,13 @@ int PDC_resize_screen(int nlines, int ncols)
         pdc_screen = SDL_GetWindowSurface(pdc_window);
     }
 
+    PDC_free_sheets();
+
     if (pdc_tileback)
         PDC_retile();
 
+    PDC_unlock_display();
+
     return OK;
 }
 
@@ -418,6 +431,8 @@ int PDC_color_content(short color, short *red, short *green, short *blue)
 
 int PDC_init_color(short color, short red, short green, short blue)
 {
+    PDC_lock_display();
+
     pdc_color[color].r = DIVROUND(red * 255, 1000);
     pdc_color[color].g = DIVROUND(green * 255, 1000);
     pdc_color[color].b = DIVROUND(blue * 255, 1000);
@@ -425,5 +440,9 @@ int PDC_init_color(short color, short red, short green, short blue)
     pdc_mapped[color] = SDL_MapRGB(pdc_screen->format, pdc_color[color].r,
                                    pdc_color[color].g, pdc_color[color].b);
 
+    PDC_free_sheets();
+
+    PDC_unlock_display();
+
     return OK;
 }
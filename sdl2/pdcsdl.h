@@ -17,8 +17,17 @@ PDCEX  int pdc_sheight, pdc_swidth, pdc_yoffset, pdc_xoffset;
 
 extern SDL_Surface *pdc_tileback;    /* used to regenerate the background
                                         of "transparent" cells */
-extern SDL_Color pdc_color[PDC_MAXCOL];  /* colors for font palette */
-extern Uint32 pdc_mapped[PDC_MAXCOL];    /* colors for FillRect(), as
+#ifdef A_RGB_COLOR
+# define PDC_RGB_SLOTS 256   /* entries past PDC_MAXCOL in pdc_color[] and
+                                pdc_mapped[], for direct-color cells */
+#else
+# define PDC_RGB_SLOTS 0
+#endif
+
+extern SDL_Color pdc_color[PDC_MAXCOL + PDC_RGB_SLOTS];
+                                     /* colors for font palette */
+extern Uint32 pdc_mapped[PDC_MAXCOL + PDC_RGB_SLOTS];
+                                     /* colors for FillRect(), as
                                             used in _highlight() */
 extern int pdc_fheight, pdc_fwidth;  /* font height and width */
 extern int pdc_fthick;               /* thickness for highlights and
@@ -31,6 +40,13 @@ extern bool pdc_own_window;          /* if pdc_window was not set
 
 PDCEX  void PDC_update_rects(void);
 PDCEX  void PDC_retile(void);
+PDCEX  void PDC_lock_display(void);
+PDCEX  void PDC_unlock_display(void);
 
 extern void PDC_pump_and_peep(void);
 extern void PDC_blink_text(void);
+extern void PDC_transform_spans(const PDC_SPAN *, int);
+extern int PDC_move_cells(int, int, int, int, int, int);
+extern void PDC_free_sheets(void);
+extern int PDC_render_start(void);
+extern void PDC_render_stop(void);
@@ -7,6 +7,11 @@ void PDC_beep(void)
     PDC_LOG(("PDC_beep() - called\n"));
 }
 
+unsigned long PDC_ms_count(void)
+{
+    return SDL_GetTicks();
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
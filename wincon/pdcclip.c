@@ -15,6 +15,8 @@ clipboard
     int PDC_setclipboard(const char *contents, long length);
     int PDC_freeclipboard(char *contents);
     int PDC_clearclipboard(void);
+    int PDC_requestclipboard(void);
+    int PDC_pollclipboard(char **contents, long *length);
 
 ### Description
 
@@ -29,6 +31,14 @@ clipboard
 
    PDC_clearclipboard() clears the internal clipboard.
 
+   PDC_requestclipboard() starts fetching the clipboard contents without
+   waiting for them to arrive. PDC_pollclipboard() returns
+   PDC_CLIP_PENDING while that request is still in flight; once it has
+   completed, it returns the contents just as PDC_getclipboard() does.
+   Here the clipboard is always available immediately, so
+   PDC_requestclipboard() does nothing, and PDC_pollclipboard() is
+   equivalent to PDC_getclipboard().
+
 ### Return Values
 
    indicator of success/failure of call.
@@ -37,6 +47,7 @@ clipboard
                            the clipboard contents
    PDC_CLIP_EMPTY          the clipboard contains no text
    PDC_CLIP_ACCESS_ERROR   no clipboard support
+   PDC_CLIP_PENDING        a requested transfer has not yet completed
 
 ### Portability
                              X/Open  ncurses  NetBSD
@@ -44,6 +55,8 @@ clipboard
     PDC_setclipboard            -       -       -
     PDC_freeclipboard           -       -       -
     PDC_clearclipboard          -       -       -
+    PDC_requestclipboard        -       -       -
+    PDC_pollclipboard           -       -       -
 
 **man-end****************************************************************/
 
@@ -139,7 +139,7 @@ void _set_ansi_color(short f, short b, attr_t attr)
 void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 {
     int j;
-    short fore, back;
+    int fore, back;
     bool blink, ansi;
 
     if (pdc_ansi && (lineno == (SP->lines - 1)) && ((x + len) == SP->cols))
@@ -153,7 +153,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         return;
     }
 
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    PDC_cell_colors(attr, &fore, &back);
     ansi = pdc_ansi || (fore >= 16 || back >= 16);
     blink = (SP->termattrs & A_BLINK) && (attr & A_BLINK);
 
@@ -285,7 +285,7 @@ void PDC_blink_text(void)
 
     for (i = 0; i < SP->lines; i++)
     {
-        const chtype *srcp = curscr->_y[i];
+        const chtype *srcp = SP->lastscr->_y[i];
 
         for (j = 0; j < SP->cols; j++)
             if (srcp[j] & A_BLINK)
@@ -10,6 +10,11 @@ void PDC_beep(void)
     MessageBeep(0XFFFFFFFF);
 }
 
+unsigned long PDC_ms_count(void)
+{
+    return GetTickCount();
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
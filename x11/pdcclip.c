@@ -15,6 +15,8 @@ clipboard
     int PDC_setclipboard(const char *contents, long length);
     int PDC_freeclipboard(char *contents);
     int PDC_clearclipboard(void);
+    int PDC_requestclipboard(void);
+    int PDC_pollclipboard(char **contents, long *length);
 
 ### Description
 
@@ -29,6 +31,18 @@ clipboard
 
    PDC_clearclipboard() clears the internal clipboard.
 
+   PDC_requestclipboard() starts fetching the clipboard contents without
+   waiting for them to arrive. PDC_pollclipboard() returns
+   PDC_CLIP_PENDING while that request is still in flight; once it has
+   completed, it returns the contents just as PDC_getclipboard() does.
+   Under X11, large selections are transferred incrementally (INCR), so
+   an application can keep drawing while a big paste trickles in; until
+   PDC_pollclipboard() has collected the result, PDC_getclipboard()
+   returns PDC_CLIP_ACCESS_ERROR rather than compete for it. On
+   platforms where the clipboard is always available immediately,
+   PDC_requestclipboard() does nothing, and PDC_pollclipboard() is
+   equivalent to PDC_getclipboard().
+
 ### Return Values
 
    indicator of success/failure of call.
@@ -36,7 +50,9 @@ clipboard
    PDC_CLIP_MEMORY_ERROR   unable to allocate sufficient memory for
                            the clipboard contents
    PDC_CLIP_EMPTY          the clipboard contains no text
-   PDC_CLIP_ACCESS_ERROR   no clipboard support
+   PDC_CLIP_ACCESS_ERROR   no clipboard support, or (under X11) a
+                           requested transfer is outstanding
+   PDC_CLIP_PENDING        a requested transfer has not yet completed
 
 ### Portability
                              X/Open  ncurses  NetBSD
@@ -44,6 +60,8 @@ clipboard
     PDC_setclipboard            -       -       -
     PDC_freeclipboard           -       -       -
     PDC_clearclipboard          -       -       -
+    PDC_requestclipboard        -       -       -
+    PDC_pollclipboard           -       -       -
 
 **man-end****************************************************************/
 
@@ -53,8 +71,14 @@ clipboard
 static char *tmpsel = NULL;
 static unsigned long tmpsel_length = 0;
 
+/* Incoming selection, assembled from one or more chunks. xc_status is
+   -1 when no request is outstanding, PDC_CLIP_PENDING while one is in
+   flight, and its final result until that's collected. */
+
 static char *xc_selection = NULL;
 static long xc_selection_len = 0;
+static long xc_selection_size = 0;
+static int xc_status = -1;
 
 #ifndef X_HAVE_UTF8_STRING
 static Atom XA_UTF8_STRING(Display *dpy)
@@ -99,24 +123,23 @@ static Boolean _convert_proc(Widget w, Atom *selection, Atom *target,
 
         XtFree((char *)std_targets);
         *type_return = XA_ATOM;
-        *format_return = 8;
+        *format_return = 32;
 
         return True;
     }
     else if (*target == XA_UTF8_STRING(XtDisplay(pdc_toplevel)) ||
              *target == XA_STRING)
     {
-        char *data = XtMalloc(tmpsel_length + 1);
-        char *tmp = tmpsel;
-        int ret_length = 0;
+        /* Xt switches to an incremental (INCR) transfer by itself when
+           this is too big for a single request */
 
-        while (*tmp)
-            data[ret_length++] = *tmp++;
+        char *data = XtMalloc(tmpsel_length + 1);
 
-        data[ret_length] = '\0';
+        memcpy(data, tmpsel, tmpsel_length);
+        data[tmpsel_length] = '\0';
 
         *value_return = data;
-        *length_return = ret_length;
+        *length_return = tmpsel_length;
         *format_return = 8;
         *type_return = *target;
 
@@ -139,65 +162,179 @@ static void _lose_ownership(Widget w, Atom *type)
     tmpsel_length = 0;
 }
 
+/* Called once per chunk of an incremental transfer, or once with the
+   whole value for an atomic one; a zero-length value marks the end */
+
 static void _get_selection(Widget w, XtPointer data, Atom *selection,
                            Atom *type, XtPointer value,
                            unsigned long *length, int *format)
 {
+    long bytes;
+
     PDC_LOG(("_get_selection() - called\n"));
 
-    if (value)
+    if (xc_status != PDC_CLIP_PENDING)
     {
-        xc_selection = value;
-        xc_selection_len = (long)(*length);
+        if (value)
+            XtFree(value);
+        return;
     }
-    else
+
+    /* no owner, no text, or the transfer timed out */
+
+    if (!value || *type == XT_CONVERT_FAIL)
+    {
+        if (value)
+            XtFree(value);
+
         xc_selection_len = 0;
+        xc_status = PDC_CLIP_EMPTY;
+        return;
+    }
+
+    bytes = (long)(*length) * (*format / 8);
+
+    if (!bytes)
+    {
+        XtFree(value);
+        xc_status = xc_selection_len ? PDC_CLIP_SUCCESS : PDC_CLIP_EMPTY;
+        return;
+    }
+
+    if (xc_selection_len + bytes >= xc_selection_size)
+    {
+        long newsize = xc_selection_size * 2;
+        char *tmp;
+
+        if (newsize <= xc_selection_len + bytes)
+            newsize = xc_selection_len + bytes + 1;
+
+        tmp = realloc(xc_selection, newsize);
+        if (!tmp)
+        {
+            XtFree(value);
+            xc_selection_len = 0;
+            xc_status = PDC_CLIP_MEMORY_ERROR;
+            return;
+        }
+
+        xc_selection = tmp;
+        xc_selection_size = newsize;
+    }
+
+    memcpy(xc_selection + xc_selection_len, value, bytes);
+    xc_selection_len += bytes;
+
+    XtFree(value);
 }
 
-int PDC_getclipboard(char **contents, long *length)
+/* Dispatch only the events that carry selection data, leaving key and
+   mouse events queued for PDC_get_key(); run due timers, so that Xt can
+   time out a stalled transfer */
+
+static void _pump_selection(void)
 {
+    Display *dpy = XtDisplay(pdc_toplevel);
+    Window win = XtWindow(pdc_toplevel);
     XEvent event;
 
-    PDC_LOG(("PDC_getclipboard() - called\n"));
+    while (xc_status == PDC_CLIP_PENDING &&
+           (XCheckTypedWindowEvent(dpy, win, SelectionNotify, &event) ||
+            XCheckTypedWindowEvent(dpy, win, PropertyNotify, &event)))
+        XtDispatchEvent(&event);
+
+    if (xc_status == PDC_CLIP_PENDING &&
+        (XtAppPending(pdc_app_context) & XtIMTimer))
+        XtAppProcessEvent(pdc_app_context, XtIMTimer);
+}
+
+/* PDC_requestclipboard() and PDC_pollclipboard(), via PDC_clip_request
+   and PDC_clip_poll */
+
+int PDC_request_selection(void)
+{
+    PDC_LOG(("PDC_request_selection() - called\n"));
+
+    if (xc_status == PDC_CLIP_PENDING)
+        return PDC_CLIP_SUCCESS;
+
+    /* drop any result that was never collected */
+
+    free(xc_selection);
 
     xc_selection = NULL;
-    xc_selection_len = -1;
+    xc_selection_len = xc_selection_size = 0;
+    xc_status = PDC_CLIP_PENDING;
 
-    XtGetSelectionValue(pdc_toplevel, XA_PRIMARY,
+    XtGetSelectionValueIncremental(pdc_toplevel, XA_PRIMARY,
 #ifdef PDC_WIDE
-                        XA_UTF8_STRING(XtDisplay(pdc_toplevel)),
+                                   XA_UTF8_STRING(XtDisplay(pdc_toplevel)),
 #else
-                        XA_STRING,
+                                   XA_STRING,
 #endif
-                        _get_selection, (XtPointer)NULL, 0);
+                                   _get_selection, (XtPointer)NULL,
+                                   CurrentTime);
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_poll_selection(char **contents, long *length)
+{
+    int status;
+
+    PDC_LOG(("PDC_poll_selection() - called\n"));
+
+    _pump_selection();
 
-    while (-1 == xc_selection_len)
+    if (PDC_CLIP_PENDING == xc_status)
+        return PDC_CLIP_PENDING;
+
+    if (-1 == xc_status)
+        return PDC_CLIP_EMPTY;
+
+    status = xc_status;
+    xc_status = -1;
+
+    if (PDC_CLIP_SUCCESS == status)
     {
-        XtAppNextEvent(pdc_app_context, &event);
-        XtDispatchEvent(&event);
+        xc_selection[xc_selection_len] = '\0';
+
+        *contents = xc_selection;
+        *length = xc_selection_len;
     }
+    else
+        free(xc_selection);
 
-    if (xc_selection && xc_selection_len)
-    {
-        *contents = malloc(xc_selection_len + 1);
+    xc_selection = NULL;
+    xc_selection_len = xc_selection_size = 0;
 
-        if (!*contents)
-            return PDC_CLIP_MEMORY_ERROR;
+    return status;
+}
 
-        memcpy(*contents, xc_selection, xc_selection_len);
+int PDC_getclipboard(char **contents, long *length)
+{
+    XEvent event;
 
-        (*contents)[xc_selection_len] = '\0';
-        *length = xc_selection_len;
+    PDC_LOG(("PDC_getclipboard() - called\n"));
 
-        return PDC_CLIP_SUCCESS;
+    /* the transfer, or its result, belongs to PDC_pollclipboard() */
+
+    if (xc_status != -1)
+        return PDC_CLIP_ACCESS_ERROR;
+
+    PDC_request_selection();
+
+    while (PDC_CLIP_PENDING == xc_status)
+    {
+        XtAppNextEvent(pdc_app_context, &event);
+        XtDispatchEvent(&event);
     }
 
-    return PDC_CLIP_EMPTY;
+    return PDC_poll_selection(contents, length);
 }
 
 int PDC_setclipboard(const char *contents, long length)
 {
-    long pos;
     int status;
 
     PDC_LOG(("PDC_setclipboard() - called\n"));
@@ -210,8 +347,7 @@ int PDC_setclipboard(const char *contents, long length)
             tmpsel = realloc(tmpsel, length + 1);
     }
 
-    for (pos = 0; pos < length; pos++)
-        tmpsel[pos] = contents[pos];
+    memcpy(tmpsel, contents, length);
 
     tmpsel_length = length;
     tmpsel[length] = 0;
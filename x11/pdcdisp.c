@@ -2,6 +2,7 @@
 
 #include "pdcx11.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef PDC_WIDE
@@ -60,14 +61,11 @@ static void _make_xy(int x, int y, int *xpos, int *ypos)
 
 static void _set_cursor_color(chtype *ch, short *fore, short *back)
 {
-    int attr;
-    short f, b;
+    int f, b;
 
-    attr = PAIR_NUMBER(*ch);
-
-    if (attr)
+    if (*ch & A_COLOR)
     {
-        pair_content(attr, &f, &b);
+        PDC_cell_colors(*ch, &f, &b);
         *fore = 7 - (f % 8);
         *back = 7 - (b % 8);
     }
@@ -95,6 +93,8 @@ static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
     PDC_LOG(("_display_cursor() - draw char at row: %d col %d\n",
              old_row, old_x));
 
+    PDC_alloc_colors();
+
     /* if the cursor position is outside the boundary of the screen,
        ignore the request */
 
@@ -107,7 +107,7 @@ static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
     PDC_LOG(("_display_cursor() - draw char at row: %d col %d\n",
              old_row, old_x));
 
-    PDC_transform_line(old_row, old_x, 1, curscr->_y[old_row] + old_x);
+    PDC_transform_line(old_row, old_x, 1, SP->lastscr->_y[old_row] + old_x);
 
     /* display the cursor at the new cursor position */
 
@@ -116,7 +116,7 @@ static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
 
     _make_xy(new_x, new_row, &xpos, &ypos);
 
-    ch = curscr->_y[new_row] + new_x;
+    ch = SP->lastscr->_y[new_row] + new_x;
     _set_cursor_color(ch, &fore, &back);
 
     if (pdc_vertical_cursor)
@@ -160,40 +160,38 @@ void PDC_redraw_cursor(void)
     _display_cursor(SP->cursrow, SP->curscol, SP->cursrow, SP->curscol);
 }
 
+static XtIntervalId blinker_id = 0;
+
 void PDC_blink_text(XtPointer unused, XtIntervalId *id)
 {
-    int row;
-    int j, k;
-    chtype *ch;
-
     PDC_LOG(("PDC_blink_text() - called:\n"));
 
+    blinker_id = 0;
+
     pdc_blinked_off = !pdc_blinked_off;
 
-    /* Redraw changed lines on the screen to match the blink state */
+    /* Redraw blinking cells on the screen to match the blink state */
 
-    for (row = 0; row < SP->lines; row++)
-    {
-        ch = curscr->_y[row];
+    PDC_redraw_blink();
+    PDC_redraw_cursor();
 
-        for (j = 0; j < COLS; j++)
-            if (ch[j] & A_BLINK)
-            {
-                k = j;
-                while (ch[k] & A_BLINK && k < COLS)
-                    k++;
+    /* If blinking has been turned off, this last pass shows the text */
 
-                PDC_transform_line(row, j, k - j, ch + j);
+    if (!(SP->termattrs & A_BLINK))
+        pdc_blinked_off = FALSE;
 
-                j = k;
-            }
-    }
+    PDC_start_blink();
+}
 
-    PDC_redraw_cursor();
+/* Start the text blink timer, unless it's already running, blinking is
+   off, or nothing on the screen blinks */
 
-    if ((SP->termattrs & A_BLINK) || !pdc_blinked_off)
-        XtAppAddTimeOut(pdc_app_context, pdc_app_data.textBlinkRate,
-                        PDC_blink_text, NULL);
+void PDC_start_blink(void)
+{
+    if (!blinker_id && (SP->termattrs & A_BLINK) && SP->opaque->blinkcount)
+        blinker_id = XtAppAddTimeOut(pdc_app_context,
+                                     pdc_app_data.textBlinkRate,
+                                     PDC_blink_text, NULL);
 }
 
 static void _toggle_cursor(void)
@@ -261,131 +259,262 @@ void PDC_gotoyx(int row, int col)
     PDC_display_cursor(SP->cursrow, SP->curscol, row, col, SP->visibility);
 }
 
-/* update the given physical line to look like the corresponding line in
-   curscr */
-
-/* Output a block of characters with common attributes */
-
-static int _new_packet(chtype attr, int len, int col, int row,
 #ifdef PDC_WIDE
-                       XChar2b *text)
+typedef XChar2b PACKTEXT;
 #else
-                       char *text)
+typedef char PACKTEXT;
 #endif
+
+/* A run of characters with common attributes. For the packets of a
+   whole update, text is an offset into frame_text. */
+
+typedef struct
 {
-    XRectangle bounds;
-    GC gc;
-    int xpos, ypos;
-    short fore, back;
-    attr_t sysattrs;
-    bool rev;
+    chtype attr;
+    int row, col, len;
+    long text;
+} PACKET;
 
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+static PACKET *packets = NULL;         /* queued by PDC_transform_spans() */
+static int npackets = 0, maxpackets = 0;
+static XRectangle *bounds = NULL;      /* one per packet */
+static PACKTEXT *frame_text = NULL;
+static long frame_textlen = 0, frame_textmax = 0;
 
-    /* Specify the color table offsets */
+#ifdef A_RGB_COLOR
 
-    sysattrs = SP->termattrs;
+/* Pixels for direct-color cells, by RGB value. Stored keys are offset
+   by one, so that an empty slot matches nothing. */
 
-    if ((attr & A_BOLD) && !(sysattrs & A_BOLD))
-        fore |= 8;
-    if ((attr & A_BLINK) && !(sysattrs & A_BLINK))
-        back |= 8;
+#define RGBCACHE 256
+
+static struct
+{
+    unsigned long rgb;
+    Pixel pixel;
+} rgbcache[RGBCACHE];
+
+static Pixel _rgb_pixel(unsigned long rgb)
+{
+    int i = (rgb ^ (rgb >> 8) ^ (rgb >> 16)) & (RGBCACHE - 1);
+
+    if (rgbcache[i].rgb != rgb + 1)
+    {
+        rgbcache[i].rgb = rgb + 1;
+        rgbcache[i].pixel = PDC_rgb_pixel(rgb);
+    }
+
+    return rgbcache[i].pixel;
+}
+
+#endif
+
+/* Work out the GC and the (reversed, if need be) pixels for attr */
+
+static GC _packet_gc(chtype attr, Pixel *fore, Pixel *back)
+{
+    attr_t sysattrs = SP->termattrs;
+    int f, b;
+
+    PDC_alloc_colors();
+
+#ifdef A_RGB_COLOR
+    if (attr & A_RGB_COLOR)
+    {
+        *fore = _rgb_pixel(PDC_RGB_FORE(attr));
+        *back = _rgb_pixel(PDC_RGB_BACK(attr));
+    }
+    else
+#endif
+    {
+        extended_pair_content(PAIR_NUMBER(attr), &f, &b);
 
-    rev = !!(attr & A_REVERSE);
+        /* Specify the color table offsets */
+
+        if ((attr & A_BOLD) && !(sysattrs & A_BOLD))
+            f |= 8;
+        if ((attr & A_BLINK) && !(sysattrs & A_BLINK))
+            b |= 8;
+
+        *fore = pdc_color[f];
+        *back = pdc_color[b];
+    }
+
+    if (attr & A_REVERSE)
+    {
+        Pixel tmp = *fore;
+        *fore = *back;
+        *back = tmp;
+    }
 
     /* Determine which GC to use - normal, italic or bold */
 
     if ((attr & A_ITALIC) && (sysattrs & A_ITALIC))
-        gc = pdc_italic_gc;
+        return pdc_italic_gc;
     else if ((attr & A_BOLD) && (sysattrs & A_BOLD))
-        gc = pdc_bold_gc;
+        return pdc_bold_gc;
     else
-        gc = pdc_normal_gc;
+        return pdc_normal_gc;
+}
 
-    _make_xy(col, row, &xpos, &ypos);
+/* Output n packets that share the attribute attr, with a single setup
+   of the GC. Their text is found at text + p[i].text. */
 
-    bounds.x = xpos;
-    bounds.y = ypos - pdc_fascent;
-    bounds.width = pdc_fwidth * len;
-    bounds.height = pdc_fheight;
+static void _draw_packets(chtype attr, const PACKET *p, int n,
+                          XRectangle *rects, const PACKTEXT *text)
+{
+    GC gc;
+    Pixel fore, back;
+    int i, xpos, ypos;
 
-    XSetClipRectangles(XCURSESDISPLAY, gc, 0, 0, &bounds, 1, Unsorted);
+    gc = _packet_gc(attr, &fore, &back);
 
-    if (pdc_blinked_off && (sysattrs & A_BLINK) && (attr & A_BLINK))
+    for (i = 0; i < n; i++)
     {
-        XSetForeground(XCURSESDISPLAY, gc, pdc_color[rev ? fore : back]);
-        XFillRectangle(XCURSESDISPLAY, XCURSESWIN, gc, xpos, bounds.y,
-                       bounds.width, pdc_fheight);
+        _make_xy(p[i].col, p[i].row, &xpos, &ypos);
+
+        rects[i].x = xpos;
+        rects[i].y = ypos - pdc_fascent;
+        rects[i].width = pdc_fwidth * p[i].len;
+        rects[i].height = pdc_fheight;
     }
-    else
+
+    XSetClipRectangles(XCURSESDISPLAY, gc, 0, 0, rects, n, Unsorted);
+
+    if (pdc_blinked_off && (SP->termattrs & A_BLINK) && (attr & A_BLINK))
     {
-        /* Draw it */
+        XSetForeground(XCURSESDISPLAY, gc, back);
+        XFillRectangles(XCURSESDISPLAY, XCURSESWIN, gc, rects, n);
+        return;
+    }
+
+    /* Draw it */
 
-        XSetForeground(XCURSESDISPLAY, gc, pdc_color[rev ? back : fore]);
-        XSetBackground(XCURSESDISPLAY, gc, pdc_color[rev ? fore : back]);
+    XSetForeground(XCURSESDISPLAY, gc, fore);
+    XSetBackground(XCURSESDISPLAY, gc, back);
+
+    for (i = 0; i < n; i++)
+    {
+        PDC_LOG(("_draw_packets() - row: %d col: %d "
+                 "num_cols: %d fore: %lx back: %lx\n",
+                 p[i].row, p[i].col, p[i].len, fore, back));
 
 #ifdef PDC_WIDE
         XDrawImageString16(
 #else
         XDrawImageString(
 #endif
-            XCURSESDISPLAY, XCURSESWIN, gc, xpos, ypos, text, len);
+            XCURSESDISPLAY, XCURSESWIN, gc, rects[i].x,
+            rects[i].y + pdc_fascent, text + p[i].text,
+            p[i].len);
+    }
 
-        /* Underline, etc. */
+    /* Underline, etc. */
 
-        if (attr & (A_LEFT | A_RIGHT | A_UNDERLINE))
-        {
-            int k;
+    if (!(attr & (A_LEFT | A_RIGHT | A_UNDERLINE)))
+        return;
 
-            if (SP->line_color != -1)
-                XSetForeground(XCURSESDISPLAY, gc, pdc_color[SP->line_color]);
+    if (SP->line_color != -1)
+        XSetForeground(XCURSESDISPLAY, gc, pdc_color[SP->line_color]);
 
-            if (attr & A_UNDERLINE)
+    for (i = 0; i < n; i++)
+    {
+        int k;
+
+        xpos = rects[i].x;
+        ypos = rects[i].y + pdc_fascent;
+
+        if (attr & A_UNDERLINE)
+            XDrawLine(XCURSESDISPLAY, XCURSESWIN, gc,
+                      xpos, ypos + 1, xpos + rects[i].width, ypos + 1);
+
+        if (attr & A_LEFT)
+            for (k = 0; k < p[i].len; k++)
+            {
+                int x = xpos + pdc_fwidth * k;
                 XDrawLine(XCURSESDISPLAY, XCURSESWIN, gc,
-                          xpos, ypos + 1, xpos + pdc_fwidth * len, ypos + 1);
-
-            if (attr & A_LEFT)
-                for (k = 0; k < len; k++)
-                {
-                    int x = xpos + pdc_fwidth * k;
-                    XDrawLine(XCURSESDISPLAY, XCURSESWIN, gc,
-                              x, ypos - pdc_fascent, x, ypos + pdc_fdescent);
-                }
-
-            if (attr & A_RIGHT)
-                for (k = 0; k < len; k++)
-                {
-                    int x = xpos + pdc_fwidth * (k + 1) - 1;
-                    XDrawLine(XCURSESDISPLAY, XCURSESWIN, gc,
-                              x, ypos - pdc_fascent, x, ypos + pdc_fdescent);
-                }
-        }
+                          x, ypos - pdc_fascent, x, ypos + pdc_fdescent);
+            }
+
+        if (attr & A_RIGHT)
+            for (k = 0; k < p[i].len; k++)
+            {
+                int x = xpos + pdc_fwidth * (k + 1) - 1;
+                XDrawLine(XCURSESDISPLAY, XCURSESWIN, gc,
+                          x, ypos - pdc_fascent, x, ypos + pdc_fdescent);
+            }
     }
+}
+
+/* Output a block of characters with common attributes */
+
+static int _new_packet(chtype attr, int len, int col, int row,
+                       PACKTEXT *text)
+{
+    PACKET p;
+    XRectangle rect;
+
+    p.attr = attr;
+    p.row = row;
+    p.col = col;
+    p.len = len;
+    p.text = 0;
 
-    PDC_LOG(("_new_packet() - row: %d col: %d "
-             "num_cols: %d fore: %d back: %d text:<%s>\n",
-             row, col, len, fore, back, text));
+    _draw_packets(attr, &p, 1, &rect, text);
 
     return OK;
 }
 
-/* The core display routine -- update one line of text */
+/* Queue a block of characters for PDC_transform_spans(); its text was
+   already written to frame_text */
 
-void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+static int _queue_packet(chtype attr, int len, int col, int row,
+                         PACKTEXT *text)
 {
-#ifdef PDC_WIDE
-    XChar2b text[513];
-#else
-    char text[513];
-#endif
-    chtype old_attr, attr;
-    int i, j;
-
-    PDC_LOG(("PDC_transform_line() - called: lineno: %d x: %d "
-             "len: %d\n", lineno, x, len));
+    PACKET *p;
 
     if (!len)
-        return;
+        return OK;
+
+    if (npackets == maxpackets)
+    {
+        int newmax = maxpackets ? maxpackets * 2 : 256;
+        XRectangle *newbounds;
+
+        p = realloc(packets, newmax * sizeof(PACKET));
+        if (!p)
+            return ERR;
+
+        packets = p;
+
+        newbounds = realloc(bounds, newmax * sizeof(XRectangle));
+        if (!newbounds)
+            return ERR;
+
+        bounds = newbounds;
+        maxpackets = newmax;
+    }
+
+    p = packets + npackets++;
+
+    p->attr = attr;
+    p->row = row;
+    p->col = col;
+    p->len = len;
+    p->text = text - frame_text;
+
+    return OK;
+}
+
+/* Split a line into packets of common attributes, with their text laid
+   out one after another from text, and pass each to out() */
+
+static int _split_line(int lineno, int x, int len, const chtype *srcp,
+                       PACKTEXT *text,
+                       int (*out)(chtype, int, int, int, PACKTEXT *))
+{
+    chtype old_attr, attr;
+    int i, j;
 
     old_attr = *srcp & A_ATTRIBUTES;
 
@@ -412,10 +541,11 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 #endif
         if (attr != old_attr)
         {
-            if (_new_packet(old_attr, i, x, lineno, text) == ERR)
-                return;
+            if (out(old_attr, i, x, lineno, text) == ERR)
+                return ERR;
 
             old_attr = attr;
+            text += i;
             x += i;
             i = 0;
         }
@@ -428,10 +558,127 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 #endif
     }
 
-    _new_packet(old_attr, i, x, lineno, text);
+    return out(old_attr, i, x, lineno, text);
+}
+
+/* The core display routine -- update one line of text */
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+    PACKTEXT text[513];
+
+    PDC_LOG(("PDC_transform_line() - called: lineno: %d x: %d "
+             "len: %d\n", lineno, x, len));
+
+    if (!len)
+        return;
+
+    _split_line(lineno, x, len, srcp, text, _new_packet);
+}
+
+/* order packets by attribute, then position */
+
+static int _packet_cmp(const void *a, const void *b)
+{
+    const PACKET *pa = a, *pb = b;
+
+    if (pa->attr != pb->attr)
+        return pa->attr < pb->attr ? -1 : 1;
+    if (pa->row != pb->row)
+        return pa->row - pb->row;
+
+    return pa->col - pb->col;
+}
+
+/* doupdate()'s changes, all at once: the packets of the whole update
+   are sorted by attribute, so that each set of them that looks alike
+   is drawn with one change of the GC */
+
+void PDC_transform_spans(const PDC_SPAN *spans, int count)
+{
+    long cells = 0;
+    int i, j;
+
+    PDC_LOG(("PDC_transform_spans() - called: count: %d\n", count));
+
+    for (i = 0; i < count; i++)
+        cells += spans[i].len;
+
+    if (cells > frame_textmax)
+    {
+        PACKTEXT *tmp = realloc(frame_text, cells * sizeof(PACKTEXT));
+
+        if (tmp)
+        {
+            frame_text = tmp;
+            frame_textmax = cells;
+        }
+    }
+
+    npackets = 0;
+    frame_textlen = 0;
+
+    for (i = 0; cells <= frame_textmax && i < count; i++)
+    {
+        if (_split_line(spans[i].y, spans[i].x, spans[i].len,
+                        spans[i].srcp, frame_text + frame_textlen,
+                        _queue_packet) == ERR)
+            break;
+
+        frame_textlen += spans[i].len;
+    }
+
+    /* short of memory -- draw line by line */
+
+    if (cells > frame_textmax || i < count)
+    {
+        for (i = 0; i < count; i++)
+            PDC_transform_line(spans[i].y, spans[i].x, spans[i].len,
+                               spans[i].srcp);
+        return;
+    }
+
+    qsort(packets, npackets, sizeof(PACKET), _packet_cmp);
+
+    for (i = 0; i < npackets; i = j)
+    {
+        for (j = i + 1; j < npackets && packets[j].attr == packets[i].attr;
+             j++)
+            ;
+
+        _draw_packets(packets[i].attr, packets + i, j - i, bounds,
+                      frame_text);
+    }
+}
+
+/* Move what's shown in a rectangle of cells, as doupdate() asks when
+   a window or pad scrolls; see PDC_move_rect in IMPLEMNT.md */
+
+int PDC_move_cells(int top, int left, int bottom, int right, int dy, int dx)
+{
+    int row = SP->cursrow, col = SP->curscol;
+    int height = bottom - top + 1 - abs(dy);
+    int width = right - left + 1 - abs(dx);
+
+    PDC_LOG(("PDC_move_cells() - called: dy %d dx %d\n", dy, dx));
+
+    /* take the cursor off the screen, so it isn't copied */
+
+    if (row < SP->lines && col < COLS)
+        PDC_transform_line(row, col, 1, SP->lastscr->_y[row] + col);
+
+    XCopyArea(XCURSESDISPLAY, XCURSESWIN, XCURSESWIN, pdc_copy_gc,
+              (dx > 0 ? left + dx : left) * pdc_fwidth,
+              (dy > 0 ? top + dy : top) * pdc_fheight,
+              width * pdc_fwidth, height * pdc_fheight,
+              (dx < 0 ? left - dx : left) * pdc_fwidth,
+              (dy < 0 ? top - dy : top) * pdc_fheight);
+
+    return OK;
 }
 
 void PDC_doupdate(void)
 {
+    PDC_start_blink();
     XSync(XtDisplay(pdc_toplevel), False);
 }
@@ -362,8 +362,6 @@ static unsigned long _process_mouse_event(XEvent *event)
            mouse scroll up and down, and button 6 and 7, which are
            normally mapped to the wheel mouse scroll left and right */
 
-        last_button_no = button_no;
-
         if (button_no >= 4 && button_no <= 7)
         {
             /* Send the KEY_MOUSE to curses program */
@@ -393,21 +391,13 @@ static unsigned long _process_mouse_event(XEvent *event)
 
         MOUSE_LOG(("\nButtonPress\n"));
 
-        SP->mouse_status.button[button_no - 1] = BUTTON_PRESSED;
+        if (button_no > 3)
+            return -1;
 
-        napms(SP->mouse_wait);
-        while (XtAppPending(pdc_app_context))
-        {
-            XEvent rel;
-            XtAppNextEvent(pdc_app_context, &rel);
+        last_button_no = button_no;
 
-            if (rel.type == ButtonRelease && rel.xbutton.button == button_no)
-                SP->mouse_status.button[button_no - 1] = BUTTON_CLICKED;
-            else
-                XSendEvent(XtDisplay(pdc_toplevel),
-                           RootWindowOfScreen(XtScreen(pdc_toplevel)),
-                           True, 0, &rel);
-        }
+        SP->mouse_status.button[button_no - 1] =
+            PDC_mouse_click(button_no, TRUE, event->xbutton.time);
 
         break;
 
@@ -426,10 +416,13 @@ static unsigned long _process_mouse_event(XEvent *event)
 
         /* ignore "releases" of scroll buttons */
 
-        if (button_no >= 4 && button_no <= 7)
+        if (button_no > 3)
             return -1;
 
-        SP->mouse_status.button[button_no - 1] = BUTTON_RELEASED;
+        /* a release soon enough after its press is a click */
+
+        SP->mouse_status.button[button_no - 1] =
+            PDC_mouse_click(button_no, FALSE, event->xbutton.time);
     }
 
     /* Set up the mouse status fields in preparation for sending */
@@ -477,6 +470,7 @@ bool PDC_check_key(void)
 int PDC_get_key(void)
 {
     XEvent event;
+    XtInputMask s;
     unsigned long newkey = 0;
     int key = 0;
 
@@ -487,6 +481,17 @@ int PDC_get_key(void)
         return KEY_RESIZE;
     }
 
+    /* if only timers (such as the resize settle timer) are due, run
+       them, rather than block in XtAppNextEvent() waiting for an X
+       event */
+
+    s = XtAppPending(pdc_app_context);
+    if (s && !(s & XtIMXEvent))
+    {
+        XtAppProcessEvent(pdc_app_context, s);
+        return -1;
+    }
+
     XtAppNextEvent(pdc_app_context, &event);
 
     switch (event.type)
@@ -149,6 +149,7 @@ XtAppContext pdc_app_context;
 Widget pdc_toplevel, pdc_drawing;
 
 GC pdc_normal_gc, pdc_cursor_gc, pdc_italic_gc, pdc_bold_gc;
+GC pdc_copy_gc;
 int pdc_fheight, pdc_fwidth, pdc_fascent, pdc_fdescent;
 int pdc_wwidth, pdc_wheight;
 bool pdc_window_entered = TRUE, pdc_resize_now = FALSE;
@@ -156,6 +157,7 @@ bool pdc_window_entered = TRUE, pdc_resize_now = FALSE;
 static Atom wm_atom[2];
 static String class_name = "XCurses";
 static int resize_window_width = 0, resize_window_height = 0;
+static XtIntervalId resize_timer = 0;
 static int received_map_notify = 0;
 static bool exposed = FALSE;
 
@@ -183,6 +185,7 @@ void PDC_scr_free(void)
     XFreeGC(XCURSESDISPLAY, pdc_italic_gc);
     XFreeGC(XCURSESDISPLAY, pdc_bold_gc);
     XFreeGC(XCURSESDISPLAY, pdc_cursor_gc);
+    XFreeGC(XCURSESDISPLAY, pdc_copy_gc);
     XDestroyIC(pdc_xic);
 }
 
@@ -191,10 +194,134 @@ void XCursesExit(void)
     PDC_scr_free();
 }
 
+/* What each color was last set to, on the 0-1000 scale of init_color(),
+   so that color_content() is answered without a trip to the server. On
+   a TrueColor visual, pixels are worked out locally from the channel
+   masks. On other visuals, init_color() only notes the change, and
+   PDC_alloc_colors() allocates the pixels before the next drawing: a
+   color redefined several times in between costs one allocation, and
+   the cells it replaces are freed in a single request. */
+
+static short color_rgb[PDC_MAXCOL][3];
+static bool color_pending[PDC_MAXCOL];  /* needs a pixel allocated */
+static bool color_owned[PDC_MAXCOL];    /* pixel was allocated by us */
+static bool colors_pending = FALSE;     /* any color_pending[] set */
+static bool truecolor = FALSE;
+
+/* Scale a 16-bit channel to fill the bits of mask */
+
+static Pixel _scale_channel(unsigned long v, unsigned long mask)
+{
+    int shift = 0, width = 0;
+
+    if (!mask)
+        return 0;
+
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        shift++;
+    }
+
+    while (mask & 1)
+    {
+        mask >>= 1;
+        width++;
+    }
+
+    v = (width < 16) ? v >> (16 - width) : v << (width - 16);
+
+    return (Pixel)v << shift;
+}
+
+/* ...and back, from a pixel to the 0-1000 scale */
+
+static short _channel_value(Pixel p, unsigned long mask)
+{
+    unsigned long low = mask & (~mask + 1);
+
+    if (!mask)
+        return 0;
+
+    return DIVROUND((p & mask) / low * 1000, mask / low);
+}
+
+static unsigned short _to16(short v)
+{
+    return (v <= 0) ? 0 : ((double)v * 65535 / 1000) + 0.5;
+}
+
+static void _set_color(int color, short red, short green, short blue)
+{
+    color_rgb[color][0] = red;
+    color_rgb[color][1] = green;
+    color_rgb[color][2] = blue;
+
+    if (truecolor)
+    {
+        Visual *vis = DefaultVisual(XCURSESDISPLAY,
+                                    DefaultScreen(XCURSESDISPLAY));
+
+        pdc_color[color] = _scale_channel(_to16(red), vis->red_mask) |
+                           _scale_channel(_to16(green), vis->green_mask) |
+                           _scale_channel(_to16(blue), vis->blue_mask);
+    }
+    else
+    {
+        color_pending[color] = TRUE;
+        colors_pending = TRUE;
+    }
+}
+
+void PDC_alloc_colors(void)
+{
+    Colormap cmap;
+    Pixel freed[PDC_MAXCOL];
+    int i, n = 0;
+
+    if (!colors_pending)
+        return;
+
+    colors_pending = FALSE;
+    cmap = DefaultColormap(XCURSESDISPLAY, DefaultScreen(XCURSESDISPLAY));
+
+    for (i = 0; i < PDC_MAXCOL; i++)
+        if (color_pending[i] && color_owned[i])
+        {
+            freed[n++] = pdc_color[i];
+            color_owned[i] = FALSE;
+        }
+
+    if (n)
+        XFreeColors(XCURSESDISPLAY, cmap, freed, n, 0);
+
+    for (i = 0; i < PDC_MAXCOL; i++)
+        if (color_pending[i])
+        {
+            XColor tmp;
+
+            tmp.red = _to16(color_rgb[i][0]);
+            tmp.green = _to16(color_rgb[i][1]);
+            tmp.blue = _to16(color_rgb[i][2]);
+
+            if (XAllocColor(XCURSESDISPLAY, cmap, &tmp))
+            {
+                pdc_color[i] = tmp.pixel;
+                color_owned[i] = TRUE;
+            }
+
+            color_pending[i] = FALSE;
+        }
+}
+
 static void _initialize_colors(void)
 {
+    Visual *vis = DefaultVisual(XCURSESDISPLAY,
+                                DefaultScreen(XCURSESDISPLAY));
     int i, r, g, b;
 
+    truecolor = (vis->class == TrueColor);
+
     pdc_color[COLOR_BLACK]   = pdc_app_data.colorBlack;
     pdc_color[COLOR_RED]     = pdc_app_data.colorRed;
     pdc_color[COLOR_GREEN]   = pdc_app_data.colorGreen;
@@ -213,9 +340,35 @@ static void _initialize_colors(void)
     pdc_color[COLOR_CYAN + 8]    = pdc_app_data.colorBoldCyan;
     pdc_color[COLOR_WHITE + 8]   = pdc_app_data.colorBoldWhite;
 
-#define RGB(R, G, B) ( ((unsigned long)(R) << 16) | \
-                       ((unsigned long)(G) << 8) | \
-                       ((unsigned long)(B)) )
+    /* the values of the colors set from resources; on a colormapped
+       visual, they're fetched in one request */
+
+    if (truecolor)
+        for (i = 0; i < 16; i++)
+        {
+            color_rgb[i][0] = _channel_value(pdc_color[i], vis->red_mask);
+            color_rgb[i][1] = _channel_value(pdc_color[i], vis->green_mask);
+            color_rgb[i][2] = _channel_value(pdc_color[i], vis->blue_mask);
+        }
+    else
+    {
+        XColor tmp[16];
+
+        for (i = 0; i < 16; i++)
+            tmp[i].pixel = pdc_color[i];
+
+        XQueryColors(XCURSESDISPLAY, DefaultColormap(XCURSESDISPLAY,
+                     DefaultScreen(XCURSESDISPLAY)), tmp, 16);
+
+        for (i = 0; i < 16; i++)
+        {
+            color_rgb[i][0] = ((double)(tmp[i].red) * 1000 / 65535) + 0.5;
+            color_rgb[i][1] = ((double)(tmp[i].green) * 1000 / 65535) + 0.5;
+            color_rgb[i][2] = ((double)(tmp[i].blue) * 1000 / 65535) + 0.5;
+        }
+    }
+
+#define C(v) DIVROUND((v) * 1000, 255)
 
     /* 256-color xterm extended palette: 216 colors in a 6x6x6 color
        cube, plus 24 shades of gray */
@@ -223,13 +376,23 @@ static void _initialize_colors(void)
     for (i = 16, r = 0; r < 6; r++)
         for (g = 0; g < 6; g++)
             for (b = 0; b < 6; b++)
-                pdc_color[i++] = RGB(r ? r * 40 + 55 : 0,
-                                     g ? g * 40 + 55 : 0,
-                                     b ? b * 40 + 55 : 0);
+                _set_color(i++, C(r ? r * 40 + 55 : 0),
+                                C(g ? g * 40 + 55 : 0),
+                                C(b ? b * 40 + 55 : 0));
     for (i = 0; i < 24; i++)
-        pdc_color[i + 232] = RGB(i * 10 + 8, i * 10 + 8, i * 10 + 8);
+        _set_color(i + 232, C(i * 10 + 8), C(i * 10 + 8), C(i * 10 + 8));
+
+#undef C
 
-#undef RGB
+    /* the rest start out black */
+
+    for (i = 256; i < PDC_MAXCOL; i++)
+    {
+        pdc_color[i] = pdc_color[COLOR_BLACK];
+        color_rgb[i][0] = color_rgb[COLOR_BLACK][0];
+        color_rgb[i][1] = color_rgb[COLOR_BLACK][1];
+        color_rgb[i][2] = color_rgb[COLOR_BLACK][2];
+    }
 }
 
 static void _get_icon(void)
@@ -317,11 +480,11 @@ static void _display_screen(void)
 
     PDC_LOG(("_display_screen() - called\n"));
 
-    if (!curscr)
+    if (!SP->lastscr)
         return;
 
     for (row = 0; row < SP->lines; row++)
-        PDC_transform_line(row, 0, COLS, curscr->_y[row]);
+        PDC_transform_line(row, 0, COLS, SP->lastscr->_y[row]);
 
     PDC_redraw_cursor();
 }
@@ -342,6 +505,34 @@ static void _handle_expose(Widget w, XtPointer client_data, XEvent *event,
         _display_screen();
 }
 
+/* Redraw the cells that PDC_move_cells() couldn't copy, because that
+   part of the window was obscured */
+
+static void _handle_graphics_expose(Widget w, XtPointer client_data,
+                                    XEvent *event, Boolean *unused)
+{
+    XGraphicsExposeEvent *ge = (XGraphicsExposeEvent *)event;
+    int row, col, last_row, last_col;
+
+    if (event->type != GraphicsExpose || !SP->lastscr)
+        return;
+
+    PDC_LOG(("_handle_graphics_expose() - called\n"));
+
+    col = ge->x / pdc_fwidth;
+    last_col = min((ge->x + ge->width - 1) / pdc_fwidth, COLS - 1);
+    last_row = min((ge->y + ge->height - 1) / pdc_fheight, SP->lines - 1);
+
+    if (col > last_col)
+        return;
+
+    for (row = ge->y / pdc_fheight; row <= last_row; row++)
+        PDC_transform_line(row, col, last_col - col + 1,
+                           SP->lastscr->_y[row] + col);
+
+    PDC_redraw_cursor();
+}
+
 static void _handle_nonmaskable(Widget w, XtPointer client_data, XEvent *event,
                                 Boolean *unused)
 {
@@ -391,6 +582,16 @@ static void _handle_enter_leave(Widget w, XtPointer client_data,
     }
 }
 
+static void _resize_settled(XtPointer unused, XtIntervalId *id)
+{
+    PDC_LOG(("_resize_settled() - called\n"));
+
+    resize_timer = 0;
+
+    SP->resized = TRUE;
+    pdc_resize_now = TRUE;
+}
+
 static void _handle_structure_notify(Widget w, XtPointer client_data,
                                      XEvent *event, Boolean *unused)
 {
@@ -407,8 +608,14 @@ static void _handle_structure_notify(Widget w, XtPointer client_data,
         resize_window_width = event->xconfigure.width;
         resize_window_height = event->xconfigure.height;
 
-        SP->resized = TRUE;
-        pdc_resize_now = TRUE;
+        /* A drag sends a stream of these; report only the size it
+           settles on */
+
+        if (resize_timer)
+            XtRemoveTimeOut(resize_timer);
+
+        resize_timer = XtAppAddTimeOut(pdc_app_context, PDC_RESIZE_SETTLE,
+                                       _resize_settled, NULL);
         break;
 
     case MapNotify:
@@ -586,6 +793,11 @@ int PDC_scr_open(void)
     SP->termattrs = A_COLOR | A_ITALIC | A_UNDERLINE | A_LEFT | A_RIGHT |
                     A_REVERSE;
 
+    PDC_transform_frame = PDC_transform_spans;
+    PDC_move_rect = PDC_move_cells;
+    PDC_clip_request = PDC_request_selection;
+    PDC_clip_poll = PDC_poll_selection;
+
     /* Add Event handlers to the drawing widget */
 
     XtAddEventHandler(pdc_drawing, ExposureMask, False, _handle_expose, NULL);
@@ -594,6 +806,7 @@ int PDC_scr_open(void)
     XtAddEventHandler(pdc_drawing, EnterWindowMask | LeaveWindowMask, False,
                       _handle_enter_leave, NULL);
     XtAddEventHandler(pdc_toplevel, 0, True, _handle_nonmaskable, NULL);
+    XtAddEventHandler(pdc_drawing, 0, True, _handle_graphics_expose, NULL);
 
     /* If there is a cursorBlink resource, start the Timeout event */
 
@@ -630,6 +843,11 @@ int PDC_scr_open(void)
     XSetLineAttributes(XCURSESDISPLAY, pdc_cursor_gc, 2,
                        LineSolid, CapButt, JoinMiter);
 
+    /* for PDC_move_cells(); it's left unclipped, and with graphics
+       exposures on, so that what can't be copied gets redrawn */
+
+    pdc_copy_gc = XCreateGC(XCURSESDISPLAY, XCURSESWIN, 0L, NULL);
+
     /* Set the pointer for the application */
 
     _pointer_setup();
@@ -652,6 +870,13 @@ int PDC_scr_open(void)
     atexit(PDC_scr_free);
 
     XSync(XtDisplay(pdc_toplevel), True);
+
+    if (resize_timer)
+    {
+        XtRemoveTimeOut(resize_timer);
+        resize_timer = 0;
+    }
+
     SP->resized = pdc_resize_now = FALSE;
 
     return OK;
@@ -699,33 +924,47 @@ bool PDC_can_change_color(void)
 
 int PDC_color_content(short color, short *red, short *green, short *blue)
 {
-    XColor tmp;
-    Colormap cmap = DefaultColormap(XCURSESDISPLAY,
-                                    DefaultScreen(XCURSESDISPLAY));
-
-    tmp.pixel = pdc_color[color];
-    XQueryColor(XCURSESDISPLAY, cmap, &tmp);
-
-    *red = ((double)(tmp.red) * 1000 / 65535) + 0.5;
-    *green = ((double)(tmp.green) * 1000 / 65535) + 0.5;
-    *blue = ((double)(tmp.blue) * 1000 / 65535) + 0.5;
+    *red = color_rgb[color][0];
+    *green = color_rgb[color][1];
+    *blue = color_rgb[color][2];
 
     return OK;
 }
 
-int PDC_init_color(short color, short red, short green, short blue)
+/* The pixel for 0xRRGGBB, for direct-color cells; on a colormapped
+   visual, it's allocated right away */
+
+Pixel PDC_rgb_pixel(unsigned long rgb)
 {
+    unsigned long r = ((rgb >> 16) & 0xff) * 257,
+                  g = ((rgb >> 8) & 0xff) * 257,
+                  b = (rgb & 0xff) * 257;
+    int scr = DefaultScreen(XCURSESDISPLAY);
     XColor tmp;
 
-    tmp.red = ((double)red * 65535 / 1000) + 0.5;
-    tmp.green = ((double)green * 65535 / 1000) + 0.5;
-    tmp.blue = ((double)blue * 65535 / 1000) + 0.5;
+    if (truecolor)
+    {
+        Visual *vis = DefaultVisual(XCURSESDISPLAY, scr);
 
-    Colormap cmap = DefaultColormap(XCURSESDISPLAY,
-                                    DefaultScreen(XCURSESDISPLAY));
+        return _scale_channel(r, vis->red_mask) |
+               _scale_channel(g, vis->green_mask) |
+               _scale_channel(b, vis->blue_mask);
+    }
+
+    tmp.red = r;
+    tmp.green = g;
+    tmp.blue = b;
 
-    if (XAllocColor(XCURSESDISPLAY, cmap, &tmp))
-        pdc_color[color] = tmp.pixel;
+    if (!XAllocColor(XCURSESDISPLAY, DefaultColormap(XCURSESDISPLAY, scr),
+                     &tmp))
+        tmp.pixel = BlackPixel(XCURSESDISPLAY, scr);
+
+    return tmp.pixel;
+}
+
+int PDC_init_color(short color, short red, short green, short blue)
+{
+    _set_color(color, red, green, blue);
 
     return OK;
 }
@@ -13,6 +13,7 @@ pdcsetsc
 
     int PDC_set_blink(bool blinkon);
     int PDC_set_bold(bool boldon);
+    int PDC_set_render_thread(bool on);
     void PDC_set_title(const char *title);
 
 ### Description
@@ -28,6 +29,14 @@ pdcsetsc
    (FALSE). It returns OK if it could set the state to match the given
    parameter, ERR otherwise.
 
+   PDC_set_render_thread() toggles whether drawing is done on a thread
+   of its own (TRUE), or by doupdate() itself (FALSE, the default). With
+   the thread, doupdate() just hands over the changes, and returns
+   without waiting for the display; if the thread falls behind, the
+   updates it hasn't drawn yet are merged into one. Only the SDL2 port
+   supports this. It returns OK if it could set the state to match the
+   given parameter, ERR otherwise.
+
    PDC_set_title() sets the title of the window in which the curses
    program is running. This function may not do anything on some
    platforms.
@@ -36,6 +45,7 @@ pdcsetsc
                              X/Open  ncurses  NetBSD
     PDC_set_blink               -       -       -
     PDC_set_title               -       -       -
+    PDC_set_render_thread       -       -       -
 
 **man-end****************************************************************/
 
@@ -75,13 +85,18 @@ int PDC_set_blink(bool blinkon)
         {
             SP->termattrs |= A_BLINK;
             pdc_blinked_off = FALSE;
-            XtAppAddTimeOut(pdc_app_context, pdc_app_data.textBlinkRate,
-                            PDC_blink_text, NULL);
+            PDC_start_blink();
         }
     }
-    else
+    else if (SP->termattrs & A_BLINK)
+    {
         SP->termattrs &= ~A_BLINK;
 
+        /* show the blinking text in its non-blinking form */
+
+        PDC_redraw_blink();
+    }
+
     return OK;
 }
 
@@ -97,3 +112,8 @@ int PDC_set_bold(bool boldon)
 
     return OK;
 }
+
+int PDC_set_render_thread(bool on)
+{
+    return on ? ERR : OK;
+}
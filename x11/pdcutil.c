@@ -2,6 +2,8 @@
 
 #include "pdcx11.h"
 
+#include <sys/time.h>
+
 #if defined(HAVE_POLL) && !defined(HAVE_USLEEP)
 # include <poll.h>
 #endif
@@ -13,6 +15,15 @@ void PDC_beep(void)
     XBell(XtDisplay(pdc_toplevel), 50);
 }
 
+unsigned long PDC_ms_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000UL + tv.tv_usec / 1000;
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
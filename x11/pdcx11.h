@@ -67,6 +67,7 @@ extern XtAppContext pdc_app_context;
 extern Widget pdc_toplevel, pdc_drawing;
 
 extern GC pdc_normal_gc, pdc_cursor_gc, pdc_italic_gc, pdc_bold_gc;
+extern GC pdc_copy_gc;
 extern int pdc_fheight, pdc_fwidth, pdc_fascent, pdc_fdescent;
 extern int pdc_wwidth, pdc_wheight;
 
@@ -77,6 +78,13 @@ int PDC_display_cursor(int, int, int, int, int);
 
 void PDC_blink_cursor(XtPointer, XtIntervalId *);
 void PDC_blink_text(XtPointer, XtIntervalId *);
+void PDC_start_blink(void);
 int PDC_kb_setup(void);
 void PDC_redraw_cursor(void);
+Pixel PDC_rgb_pixel(unsigned long);
+void PDC_alloc_colors(void);
+void PDC_transform_spans(const PDC_SPAN *, int);
+int PDC_move_cells(int, int, int, int, int, int);
+int PDC_request_selection(void);
+int PDC_poll_selection(char **, long *);
 bool PDC_scrollbar_init(const char *);